@@ -0,0 +1,149 @@
+#include "allocstats.h"
+
+#if RF_ALLOC_STATS
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+
+using namespace std;
+
+/*
+ Every block is malloc'd with a header in front of the pointer handed out:
+   [raw malloc pointer][requested size] | user bytes
+ so delete can find the size (for live bytes) and the raw pointer (over-aligned
+ blocks start some way into their allocation) without a lookup table.
+*/
+
+static const char* const STAGE_NAMES[ALLOC_STAGE_COUNT] = {
+    "other", "parse", "job parse", "score", "report",
+};
+
+struct alignas(16) BlockHeader {
+    void* raw;
+    size_t size;
+};
+static_assert(sizeof(BlockHeader) == 16, "the header keeps the default new alignment");
+
+static atomic<uint64_t> stageAllocs[ALLOC_STAGE_COUNT];
+static atomic<uint64_t> stageBytes[ALLOC_STAGE_COUNT];
+static atomic<int64_t> liveBytes{ 0 };
+static atomic<int64_t> peakBytes{ 0 };
+static atomic<uint64_t> resumes{ 0 };
+static thread_local AllocStage currentStage = ALLOC_OTHER;
+
+AllocStageScope::AllocStageScope(AllocStage stage) : previous(currentStage)
+{
+    currentStage = stage;
+}
+
+AllocStageScope::~AllocStageScope()
+{
+    currentStage = previous;
+}
+
+void allocCountResume()
+{
+    resumes.fetch_add(1, memory_order_relaxed);
+}
+
+// null when malloc fails; the callers decide between throwing and returning null
+static void* countedAlloc(size_t size, size_t align)
+{
+    if (align < alignof(BlockHeader)) align = alignof(BlockHeader);
+    const size_t extra = sizeof(BlockHeader) + align - 1;
+    if (size > SIZE_MAX - extra) return nullptr;
+    char* raw = (char*)malloc(size + extra);
+    if (!raw) return nullptr;
+    const uintptr_t first = (uintptr_t)raw + sizeof(BlockHeader);
+    char* p = raw + ((first + align - 1) / align * align - (uintptr_t)raw);
+    BlockHeader* h = (BlockHeader*)p - 1;
+    h->raw = raw;
+    h->size = size;
+
+    const AllocStage stage = currentStage;
+    stageAllocs[stage].fetch_add(1, memory_order_relaxed);
+    stageBytes[stage].fetch_add(size, memory_order_relaxed);
+    const int64_t live = liveBytes.fetch_add((int64_t)size, memory_order_relaxed) + (int64_t)size;
+    int64_t peak = peakBytes.load(memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+    return p;
+}
+
+static void* countedNew(size_t size, size_t align)
+{
+    for (;;) {
+        if (void* p = countedAlloc(size, align)) return p;
+        new_handler handler = get_new_handler();
+        if (!handler) throw bad_alloc();
+        handler();
+    }
+}
+
+static void countedFree(void* p)
+{
+    if (!p) return;
+    const BlockHeader* h = (const BlockHeader*)p - 1;
+    liveBytes.fetch_sub((int64_t)h->size, memory_order_relaxed);
+    free(h->raw);
+}
+
+void printAllocStats(ostream& out)
+{
+    // taken before printing, which allocates too
+    uint64_t allocs[ALLOC_STAGE_COUNT], bytes[ALLOC_STAGE_COUNT];
+    uint64_t totalAllocs = 0, totalBytes = 0;
+    for (int s = 0; s < ALLOC_STAGE_COUNT; ++s) {
+        allocs[s] = stageAllocs[s].load();
+        bytes[s] = stageBytes[s].load();
+        totalAllocs += allocs[s];
+        totalBytes += bytes[s];
+    }
+    const uint64_t parsed = resumes.load();
+    const int64_t peak = peakBytes.load();
+
+    out << "\nHeap allocations (" << parsed << " resumes parsed):\n";
+    out << left << setw(24) << "Stage" << right << setw(14) << "Allocations" << setw(16) << "Bytes"
+        << setw(14) << "Allocs/resume" << setw(14) << "Bytes/resume" << "\n";
+    out << string(82, '-') << "\n";
+    auto row = [&](const char* name, uint64_t n, uint64_t b) {
+        out << left << setw(24) << name << right << setw(14) << n << setw(16) << b << fixed << setprecision(1);
+        if (parsed) out << setw(14) << (double)n / (double)parsed << setw(14) << (double)b / (double)parsed;
+        out << "\n";
+    };
+    for (int s = 0; s < ALLOC_STAGE_COUNT; ++s) row(STAGE_NAMES[s], allocs[s], bytes[s]);
+    row("total", totalAllocs, totalBytes);
+    out << "Peak live heap bytes: " << peak << "\n";
+    out << left;
+}
+
+// ---- the replaced global allocation functions ----
+
+void* operator new(size_t size) { return countedNew(size, 0); }
+void* operator new[](size_t size) { return countedNew(size, 0); }
+void* operator new(size_t size, const nothrow_t&) noexcept { return countedAlloc(size, 0); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return countedAlloc(size, 0); }
+void* operator new(size_t size, align_val_t align) { return countedNew(size, (size_t)align); }
+void* operator new[](size_t size, align_val_t align) { return countedNew(size, (size_t)align); }
+void* operator new(size_t size, align_val_t align, const nothrow_t&) noexcept { return countedAlloc(size, (size_t)align); }
+void* operator new[](size_t size, align_val_t align, const nothrow_t&) noexcept { return countedAlloc(size, (size_t)align); }
+
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { countedFree(p); }
+void operator delete(void* p, align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { countedFree(p); }
+void operator delete(void* p, align_val_t, const nothrow_t&) noexcept { countedFree(p); }
+void operator delete[](void* p, align_val_t, const nothrow_t&) noexcept { countedFree(p); }
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <cstdint>
+#include <iosfwd>
+
+using namespace std;
+
+// Heap accounting: build with RF_ALLOC_STATS=1 (-DRF_ALLOC_STATS=1, /DRF_ALLOC_STATS=1)
+// and the global operator new / delete are replaced by counting versions. Every
+// allocation is charged to the stage the allocating thread is in (RF_ALLOC_STAGE
+// marks them), and the run ends with allocations and bytes per stage, per resume
+// parsed, and the peak of live heap bytes. Off by default: the regular build keeps
+// the library allocator and the macros below expand to nothing.
+#ifndef RF_ALLOC_STATS
+#define RF_ALLOC_STATS 0
+#endif
+
+enum AllocStage {
+    ALLOC_OTHER,            // anything outside a marked stage (startup, console output)
+    ALLOC_PARSE,            // listing, reading and parsing resumes, the ingest cache
+    ALLOC_JOB_PARSE,
+    ALLOC_SCORE,            // the scoring pool and its keyword index, scoring, ranking
+    ALLOC_REPORT,           // console results and report files
+    ALLOC_STAGE_COUNT
+};
+
+#if RF_ALLOC_STATS
+
+// Charges the current thread's allocations to `stage` until the scope ends, then goes
+// back to the stage it was in; a stage nested in another (scoring inside a streamed
+// parse) gets its own allocations.
+struct AllocStageScope {
+    AllocStage previous;
+    explicit AllocStageScope(AllocStage stage);
+    ~AllocStageScope();
+    AllocStageScope(const AllocStageScope&) = delete;
+    AllocStageScope& operator=(const AllocStageScope&) = delete;
+};
+
+void allocCountResume();
+// Call once all workers have joined.
+void printAllocStats(ostream& out);
+
+#define RF_ALLOC_CONCAT2(a, b) a##b
+#define RF_ALLOC_CONCAT(a, b) RF_ALLOC_CONCAT2(a, b)
+#define RF_ALLOC_STAGE(stage) AllocStageScope RF_ALLOC_CONCAT(rfAllocStage, __LINE__)(stage)
+#define RF_ALLOC_RESUME() allocCountResume()
+
+#else
+
+#define RF_ALLOC_STAGE(stage) ((void)0)
+#define RF_ALLOC_RESUME() ((void)0)
+
+#endif
+
+#endif // ALLOCSTATS_H
@@ -0,0 +1,274 @@
+#include "bundle.h"
+#include "fileloader.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+/*
+ Layout (tar, 512-byte blocks):
+   per file: TarHeader, then the file's bytes padded to a whole block
+   a long name comes first as its own record (GNU type 'L' or a pax 'x' path)
+   two zero blocks end the archive
+*/
+
+static const size_t BLOCK = 512;
+
+struct TarHeader {
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char type;
+    char linkName[100];
+    char magic[6];
+    char version[2];
+    char userName[32];
+    char groupName[32];
+    char devMajor[8];
+    char devMinor[8];
+    char prefix[155];
+    char pad[12];
+};
+static_assert(sizeof(TarHeader) == BLOCK, "tar headers are one block");
+
+static inline uint64_t roundToBlock(uint64_t n)
+{
+    return (n + BLOCK - 1) / BLOCK * BLOCK;
+}
+
+// string in a fixed-width field, which need not be NUL-terminated
+static string fieldText(const char* field, size_t width)
+{
+    return string(field, find(field, field + width, '\0'));
+}
+
+// octal digits (padded with spaces or NULs), or GNU base-256 when the top bit is set
+static bool fieldNumber(const char* field, size_t width, uint64_t& out)
+{
+    out = 0;
+    if ((unsigned char)field[0] & 0x80) {
+        out = (unsigned char)field[0] & 0x7f;
+        for (size_t i = 1; i < width; ++i) out = (out << 8) | (unsigned char)field[i];
+        return true;
+    }
+    size_t i = 0;
+    while (i < width && field[i] == ' ') i++;
+    bool any = false;
+    for (; i < width && field[i] >= '0' && field[i] <= '7'; ++i) {
+        out = out * 8 + (uint64_t)(field[i] - '0');
+        any = true;
+    }
+    return any && (i == width || field[i] == ' ' || field[i] == '\0');
+}
+
+// unsigned sum of the header bytes with the checksum field read as spaces
+static uint64_t headerChecksum(const TarHeader& h)
+{
+    const unsigned char* p = (const unsigned char*)&h;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < BLOCK; ++i) sum += p[i];
+    for (char ch : h.checksum) sum = sum - (unsigned char)ch + ' ';
+    return sum;
+}
+
+// the "path" record of a pax extended header ("<length> <key>=<value>\n" records)
+static bool paxPath(const char* data, size_t size, string& path)
+{
+    size_t pos = 0;
+    bool found = false;
+    while (pos < size) {
+        size_t len = 0, i = pos;
+        for (; i < size && data[i] >= '0' && data[i] <= '9'; ++i) len = len * 10 + (size_t)(data[i] - '0');
+        if (i >= size || data[i] != ' ' || len == 0 || pos + len > size) break;
+        const char* record = data + i + 1;
+        const char* end = data + pos + len - 1;     // the record's '\n'
+        const char* eq = find(record, end, '=');
+        if (eq != end && string(record, eq) == "path") {
+            path.assign(eq + 1, end);
+            found = true;
+        }
+        pos += len;
+    }
+    return found;
+}
+
+bool listBundle(const char* data, size_t size, const string& path, vector<BundleEntry>& entries)
+{
+    RF_TIMED_SCOPE("list bundle");
+    entries.clear();
+    if (size > 0 && size < BLOCK) {
+        cout << "Not a resume bundle (tar archive): " << path << "\n";
+        return false;
+    }
+    string longName;    // from a preceding 'L' or 'x' record, for the next file only
+    size_t pos = 0;
+    bool stopped = false;
+    while (pos + BLOCK <= size) {
+        TarHeader h;
+        memcpy(&h, data + pos, BLOCK);
+        const char* raw = (const char*)&h;
+        if (all_of(raw, raw + BLOCK, [](char ch) { return ch == '\0'; })) return true;   // end of archive
+
+        uint64_t checksum = 0, length = 0, mtime = 0;
+        if (!fieldNumber(h.checksum, sizeof(h.checksum), checksum) || checksum != headerChecksum(h)
+            || !fieldNumber(h.size, sizeof(h.size), length)) {
+            if (pos == 0) {
+                cout << "Not a resume bundle (tar archive): " << path << "\n";
+                return false;
+            }
+            cout << "Bundle is damaged at offset " << pos << ", ignoring the rest: " << path << "\n";
+            return true;
+        }
+        const uint64_t body = pos + BLOCK;
+        if (length > size - body) {
+            stopped = true;
+            break;
+        }
+
+        switch (h.type) {
+        case 'L':   // GNU long name
+            longName = fieldText(data + body, (size_t)length);
+            break;
+        case 'x':   // pax extended header
+            if (!paxPath(data + body, (size_t)length, longName)) longName.clear();
+            break;
+        case '0':
+        case '\0':
+        case '7': {
+            BundleEntry e;
+            if (!longName.empty()) {
+                e.name = move(longName);
+            }
+            else {
+                e.name = fieldText(h.name, sizeof(h.name));
+                // POSIX ustar keeps the leading directories of a long path apart
+                const string prefix = fieldText(h.prefix, sizeof(h.prefix));
+                if (memcmp(h.magic, "ustar\0", 6) == 0 && !prefix.empty()) e.name = prefix + "/" + e.name;
+            }
+            fieldNumber(h.mtime, sizeof(h.mtime), mtime);
+            e.offset = body;
+            e.size = length;
+            e.mtime = (int64_t)mtime;
+            entries.push_back(move(e));
+            longName.clear();
+            break;
+        }
+        default:    // directories, links, global pax headers: nothing to read
+            longName.clear();
+            break;
+        }
+        pos = (size_t)min<uint64_t>(size, body + roundToBlock(length));
+    }
+    // a header or a file cut short; a missing end marker alone is fine
+    if (stopped || pos < size) cout << "Bundle is truncated, ignoring its last file: " << path << "\n";
+    return true;
+}
+
+static int64_t modifiedSeconds(const string& path)
+{
+#ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path.c_str(), &st) != 0) return 0;
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return 0;
+#endif
+    return (int64_t)st.st_mtime;
+}
+
+// zero-padded octal and a NUL; values too large for the field are clamped
+static void putOctal(char* field, size_t width, uint64_t value)
+{
+    const uint64_t limit = (1ull << (3 * (width - 1))) - 1;
+    value = min(value, limit);
+    for (size_t i = width - 1; i-- > 0; value >>= 3) field[i] = (char)('0' + (value & 7));
+    field[width - 1] = '\0';
+}
+
+// one header (GNU format) and the padded body
+static void writeRecord(ostream& out, const string& name, char type, const char* body, uint64_t length, int64_t mtime)
+{
+    TarHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.name, name.data(), min(name.size(), sizeof(h.name)));
+    putOctal(h.mode, sizeof(h.mode), 0644);
+    putOctal(h.uid, sizeof(h.uid), 0);
+    putOctal(h.gid, sizeof(h.gid), 0);
+    putOctal(h.size, sizeof(h.size), length);
+    putOctal(h.mtime, sizeof(h.mtime), (uint64_t)max<int64_t>(mtime, 0));
+    h.type = type;
+    memcpy(h.magic, "ustar ", 6);
+    memcpy(h.version, " \0", 2);
+    memset(h.checksum, ' ', sizeof(h.checksum));
+    putOctal(h.checksum, 7, headerChecksum(h));     // six digits and a NUL; the space stays
+    out.write((const char*)&h, BLOCK);
+
+    static const char zeros[BLOCK] = {};
+    out.write(body, (streamsize)length);
+    out.write(zeros, (streamsize)(roundToBlock(length) - length));
+}
+
+bool packBundle(const string& folderPath, const string& bundlePath, size_t* count)
+{
+    RF_TIMED_SCOPE("pack bundle");
+    // sorted, so packing the same folder twice gives the same archive
+    vector<string> names;
+    try {
+        for (auto& ent : fs::directory_iterator(folderPath)) {
+            if (ent.is_regular_file() && ent.path().extension() == ".txt") names.push_back(ent.path().filename().string());
+        }
+    }
+    catch (const std::exception& e) {
+        cout << "Error reading folder: " << e.what() << "\n";
+        return false;
+    }
+    sort(names.begin(), names.end());
+
+    ofstream out(bundlePath, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Cannot write bundle: " << bundlePath << "\n";
+        return false;
+    }
+
+    const size_t batch = 64;
+    vector<string> paths, data(batch);
+    vector<FileLoadError> errors(batch);
+    size_t packed = 0;
+    for (size_t first = 0; first < names.size(); first += batch) {
+        const size_t n = min(batch, names.size() - first);
+        paths.clear();
+        for (size_t k = 0; k < n; ++k) paths.push_back((fs::path(folderPath) / names[first + k]).string());
+        loadFiles(paths.data(), n, 0, data.data(), errors.data());
+        for (size_t k = 0; k < n; ++k) {
+            if (errors[k] != LOAD_OK) {
+                cout << "Warning: cannot read " << paths[k] << ", left out of the bundle\n";
+                continue;
+            }
+            const string& name = names[first + k];
+            // GNU long name record: the name, NUL-terminated, as the body
+            if (name.size() >= sizeof(TarHeader::name)) writeRecord(out, "././@LongLink", 'L', name.c_str(), name.size() + 1, 0);
+            writeRecord(out, name, '0', data[k].data(), data[k].size(), modifiedSeconds(paths[k]));
+            packed++;
+        }
+    }
+    static const char end[2 * BLOCK] = {};
+    out.write(end, sizeof(end));
+    out.close();
+    if (!out) {
+        cout << "Failed writing bundle: " << bundlePath << "\n";
+        return false;
+    }
+    if (count) *count = packed;
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef BUNDLE_H
+#define BUNDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Resume bundles: many resumes in one tar archive, so a large pool is one file to
+// copy and read sequentially instead of millions of small files. The parser maps the
+// archive and parses each record straight out of the mapping (parser.h takes a bundle
+// wherever it takes a resume folder). Archives from `tar`, including GNU long names
+// and pax path records, work as well as ones written by packBundle.
+struct BundleEntry {
+    string name;            // path inside the archive
+    uint64_t offset = 0;    // of the file's bytes in the archive
+    uint64_t size = 0;
+    int64_t mtime = 0;      // seconds since 1970, as recorded in the archive
+};
+
+// Lists the regular files of the archive in data / size, in archive order. False
+// (after a message) if it is not a tar archive; a damaged or truncated archive keeps
+// the entries before the damage.
+bool listBundle(const char* data, size_t size, const string& path, vector<BundleEntry>& entries);
+
+// Writes every .txt file directly inside the folder to a new archive at bundlePath,
+// sorted by name, and sets *count to the number of files packed. Files that cannot be
+// read are left out after a warning.
+bool packBundle(const string& folderPath, const string& bundlePath, size_t* count = nullptr);
+
+#endif // BUNDLE_H
@@ -0,0 +1,171 @@
+#include "candidatepool.h"
+#include "allocstats.h"
+#include <cstring>
+
+using namespace std;
+
+// points the parse result columns at the pool's own storage
+static void bindOwnColumns(CandidatePool& p)
+{
+    CandidatePool::Storage& s = p.own;
+    p.text = columnOf(s.text);
+    p.name = columnOf(s.name);
+    p.education = columnOf(s.education);
+    p.filepath = columnOf(s.filepath);
+    p.gpa = columnOf(s.gpa);
+    p.years = columnOf(s.years);
+    p.skillStart = columnOf(s.skillStart);
+    p.skillIds = columnOf(s.skillIds);
+    p.certStart = columnOf(s.certStart);
+    p.certs = columnOf(s.certs);
+    p.duplicateStart = columnOf(s.duplicateStart);
+    p.duplicates = columnOf(s.duplicates);
+}
+
+CandidatePool::CandidatePool()
+{
+    bindOwnColumns(*this);
+}
+
+// appends t to the pool's text and returns its span
+static TextSpan appendPoolText(CandidatePool::Storage& s, string_view t)
+{
+    TextSpan span;
+    span.offset = (uint32_t)s.text.size();
+    span.length = (uint32_t)t.size();
+    s.text.insert(s.text.end(), t.begin(), t.end());
+    return span;
+}
+
+void addToPool(CandidatePool& p, const Candidate& c)
+{
+    CandidatePool::Storage& s = p.own;
+    s.name.push_back(appendPoolText(s, spanText(c, c.name)));
+    s.education.push_back(appendPoolText(s, spanText(c, c.education)));
+    s.filepath.push_back(appendPoolText(s, spanText(c, c.filepath)));
+    s.gpa.push_back(c.gpa);
+    s.years.push_back(c.experienceYears);
+    s.skillIds.insert(s.skillIds.end(), c.skills.begin(), c.skills.end());
+    s.skillStart.push_back((uint32_t)s.skillIds.size());
+
+    const uint32_t firstCert = (uint32_t)s.certs.size();
+    for (auto span : c.certifications) s.certs.push_back(appendPoolText(s, spanText(c, span)));
+    s.certStart.push_back((uint32_t)s.certs.size());
+    s.duplicateStart.push_back((uint32_t)s.duplicates.size());
+    bindOwnColumns(p);
+
+    p.score.push_back(c.score);
+    p.grade.push_back(c.grade);
+    p.matchedSkillIds.insert(p.matchedSkillIds.end(), c.matchedSkills.begin(), c.matchedSkills.end());
+    p.matchedSkillStart.push_back((uint32_t)p.matchedSkillIds.size());
+    // matched certs are spans of certifications; store which one
+    for (auto m : c.matchedCerts) {
+        uint32_t idx = firstCert;
+        for (size_t k = 0; k < c.certifications.size(); ++k) {
+            if (c.certifications[k].offset == m.offset && c.certifications[k].length == m.length) {
+                idx = firstCert + (uint32_t)k;
+                break;
+            }
+        }
+        p.matchedCerts.push_back(idx);
+    }
+    p.matchedCertStart.push_back((uint32_t)p.matchedCerts.size());
+}
+
+void addDuplicate(CandidatePool& p, string_view path)
+{
+    CandidatePool::Storage& s = p.own;
+    s.duplicates.push_back(appendPoolText(s, path));
+    s.duplicateStart.back() = (uint32_t)s.duplicates.size();
+    bindOwnColumns(p);
+}
+
+CandidatePool poolFromCandidates(vector<Candidate>&& candidates, const vector<uint32_t>* representative)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    CandidatePool p;
+    if (representative) {
+        // duplicates of each representative, in candidate order
+        const vector<uint32_t>& rep = *representative;
+        vector<uint32_t> dupStart(candidates.size() + 1, 0), dups;
+        for (size_t i = 0; i < candidates.size(); ++i) if (rep[i] != i) dupStart[rep[i] + 1]++;
+        for (size_t i = 0; i < candidates.size(); ++i) dupStart[i + 1] += dupStart[i];
+        dups.resize(dupStart.back());
+        vector<uint32_t> next(dupStart.begin(), dupStart.end() - 1);
+        for (size_t i = 0; i < candidates.size(); ++i) if (rep[i] != i) dups[next[rep[i]]++] = (uint32_t)i;
+
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (rep[i] != i) continue;
+            addToPool(p, candidates[i]);
+            addDocument(p.keywordIndex, resumeText(candidates[i]));
+            for (uint32_t k = dupStart[i]; k < dupStart[i + 1]; ++k) {
+                Candidate& d = candidates[dups[k]];
+                addDuplicate(p, spanText(d, d.filepath));
+                d = Candidate();
+            }
+            candidates[i] = Candidate();
+        }
+        candidates.clear();
+        candidates.shrink_to_fit();
+        finishTextIndex(p.keywordIndex);
+        return p;
+    }
+
+    const size_t n = candidates.size();
+    p.own.name.reserve(n);
+    p.own.education.reserve(n);
+    p.own.filepath.reserve(n);
+    p.own.gpa.reserve(n);
+    p.own.years.reserve(n);
+    p.own.skillStart.reserve(n + 1);
+    p.own.certStart.reserve(n + 1);
+    p.own.duplicateStart.reserve(n + 1);
+    p.score.reserve(n);
+    p.grade.reserve(n);
+    p.matchedSkillStart.reserve(n + 1);
+    p.matchedCertStart.reserve(n + 1);
+    for (auto& c : candidates) {
+        addToPool(p, c);
+        addDocument(p.keywordIndex, resumeText(c));
+        c = Candidate();
+    }
+    candidates.clear();
+    candidates.shrink_to_fit();
+    finishTextIndex(p.keywordIndex);
+    return p;
+}
+
+// appends s to c.text and returns its span
+static TextSpan appendText(Candidate& c, string_view s)
+{
+    TextSpan span;
+    span.offset = (uint32_t)c.text.size();
+    span.length = (uint32_t)s.size();
+    c.text.append(s.data(), s.size());
+    return span;
+}
+
+Candidate candidateFromPool(const CandidatePool& p, size_t i)
+{
+    Candidate c;
+    c.name = appendText(c, poolText(p, p.name[i]));
+    c.education = appendText(c, poolText(p, p.education[i]));
+    for (uint32_t k = p.certStart[i]; k < p.certStart[i + 1]; ++k) c.certifications.push_back(appendText(c, poolText(p, p.certs[k])));
+    c.filepath = appendText(c, poolText(p, p.filepath[i]));
+    c.gpa = p.gpa[i];
+    c.experienceYears = p.years[i];
+    c.skills.assign(p.skillIds.begin() + p.skillStart[i], p.skillIds.begin() + p.skillStart[i + 1]);
+
+    c.score = p.score[i];
+    c.grade = p.grade[i];
+    c.matchedSkills.assign(p.matchedSkillIds.begin() + p.matchedSkillStart[i], p.matchedSkillIds.begin() + p.matchedSkillStart[i + 1]);
+    for (uint32_t k = p.matchedCertStart[i]; k < p.matchedCertStart[i + 1]; ++k) {
+        c.matchedCerts.push_back(c.certifications[p.matchedCerts[k] - p.certStart[i]]);
+    }
+    return c;
+}
+
+void releasePool(CandidatePool& p)
+{
+    p = CandidatePool();
+}
@@ -0,0 +1,97 @@
+#ifndef CANDIDATEPOOL_H
+#define CANDIDATEPOOL_H
+
+#include "column.h"
+#include "parser.h"
+#include "sketch.h"
+#include "textindex.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+struct MappedFile;
+
+// Struct-of-arrays candidate storage. Entry i of every per-candidate column belongs to
+// candidate i; variable-length lists are flat arrays indexed by *Start columns that
+// hold one extra entry at the end (list i is [start[i], start[i + 1])). All text is
+// one byte column, which the string columns hold spans of (poolText). Scoring
+// (scorePool in scorer.h) sweeps the columns it needs and writes score / grade /
+// matches into the output columns.
+// The parse results are read-only views: of `own` for a pool built here, or of a
+// mapped snapshot (loadPoolSnapshot in snapshot.h) for one loaded from disk, in which
+// case `mapping` keeps the file mapped. Not copyable, since a copy's columns would
+// still point at the original's storage.
+struct CandidatePool {
+    // parse results
+    Column<char> text;
+    Column<TextSpan> name;
+    Column<TextSpan> education;
+    Column<TextSpan> filepath;
+    Column<double> gpa;                 // -1 means not found
+    Column<int32_t> years;
+    Column<uint32_t> skillStart;
+    Column<uint32_t> skillIds;          // interned ids, resume order
+    Column<uint32_t> certStart;
+    Column<TextSpan> certs;
+    Column<uint32_t> duplicateStart;
+    Column<TextSpan> duplicates;        // paths of near-duplicate resumes folded into this one
+    TextIndex keywordIndex;             // resume text by entry, for keyword relevance
+
+    // storage behind the parse results of a pool built with addToPool
+    struct Storage {
+        vector<char> text;              // not a string: moving one may move short text
+        vector<TextSpan> name;
+        vector<TextSpan> education;
+        vector<TextSpan> filepath;
+        vector<double> gpa;
+        vector<int32_t> years;
+        vector<uint32_t> skillStart = { 0 };
+        vector<uint32_t> skillIds;
+        vector<uint32_t> certStart = { 0 };
+        vector<TextSpan> certs;
+        vector<uint32_t> duplicateStart = { 0 };
+        vector<TextSpan> duplicates;
+    } own;
+    shared_ptr<const MappedFile> mapping;
+
+    // scoring results
+    vector<double> score;
+    vector<char> grade;
+    vector<uint32_t> matchedSkillStart = { 0 };
+    vector<uint32_t> matchedSkillIds;
+    vector<uint32_t> matchedCertStart = { 0 };
+    vector<uint32_t> matchedCerts;      // indexes into certs
+    vector<uint32_t> rankOrder;         // entries best first (rankPool in ranking.h), empty = unranked
+    ScoreSketch sketch;                 // every candidate scored, also those a top-k run dropped
+
+    CandidatePool();
+    CandidatePool(CandidatePool&&) = default;
+    CandidatePool& operator=(CandidatePool&&) = default;
+    CandidatePool(const CandidatePool&) = delete;
+    CandidatePool& operator=(const CandidatePool&) = delete;
+};
+
+inline size_t poolSize(const CandidatePool& p) { return p.gpa.size(); }
+inline string_view poolText(const CandidatePool& p, TextSpan s) { return string_view(p.text.data() + s.offset, s.length); }
+// the entry listed r-th: by rank once the pool is ranked, else in entry order
+inline size_t entryAtRank(const CandidatePool& p, size_t r) { return p.rankOrder.empty() ? r : p.rankOrder[r]; }
+
+// appends a copy of c, results included
+void addToPool(CandidatePool& p, const Candidate& c);
+// records another file as a duplicate of the last entry added
+void addDuplicate(CandidatePool& p, string_view path);
+// Builds a pool from candidates, freeing each one as soon as it has been copied, and
+// indexes each entry's resume text into keywordIndex (addToPool alone does not). With
+// `representative` (see dedupe.h) only representatives get an entry; every other
+// candidate becomes a duplicate path of its representative's entry.
+CandidatePool poolFromCandidates(vector<Candidate>&& candidates, const vector<uint32_t>* representative = nullptr);
+// a standalone Candidate for entry i (for code that still works on Candidate)
+Candidate candidateFromPool(const CandidatePool& p, size_t i);
+// frees everything (or unmaps it) in a handful of deallocations
+void releasePool(CandidatePool& p);
+
+#endif // CANDIDATEPOOL_H
@@ -0,0 +1,31 @@
+#ifndef COLUMN_H
+#define COLUMN_H
+
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// Read-only view of a column of T, indexed like the vector it usually stands for. It
+// points either at a vector that owns the values or straight into a memory-mapped
+// file (snapshot.h), so readers do not care which one they got.
+template <class T>
+struct Column {
+    const T* first = nullptr;
+    size_t count = 0;
+
+    const T& operator[](size_t i) const { return first[i]; }
+    const T* data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* begin() const { return first; }
+    const T* end() const { return first + count; }
+};
+
+template <class T>
+inline Column<T> columnOf(const vector<T>& v)
+{
+    return Column<T>{ v.data(), v.size() };
+}
+
+#endif // COLUMN_H
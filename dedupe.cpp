@@ -0,0 +1,180 @@
+#include "dedupe.h"
+#include "threadpool.h"
+#include "stats.h"
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+
+using namespace std;
+
+// signature layout: SIG_SLOTS minimums, split into LSH_BANDS bands of LSH_ROWS slots.
+// With 32 x 4 a pair at similarity 0.9 shares a band with probability > 0.99999 and
+// a pair at 0.3 with probability < 0.25.
+static const int SIG_SLOTS = 128;
+static const int SLOT_BITS = 7;                 // log2(SIG_SLOTS)
+static const int LSH_ROWS = 4;
+static const int LSH_BANDS = SIG_SLOTS / LSH_ROWS;
+static const uint64_t VALUE_MASK = (~0ull) >> SLOT_BITS;
+
+static inline uint64_t mix64(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline bool isWordByte(unsigned char ch)
+{
+    return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+// One-permutation MinHash: each 3-gram hash lands in one slot (its top bits) and the
+// slot keeps its smallest remaining bits. Empty slots borrow the next filled slot's
+// value, tagged with the distance, so short resumes still compare slot by slot.
+// False if the text has no words at all.
+static bool signText(string_view text, uint64_t* sig)
+{
+    fill(sig, sig + SIG_SLOTS, ~0ull);
+    uint64_t w0 = 0, w1 = 0;    // the two previous words
+    size_t words = 0;
+    auto addShingle = [&](uint64_t h) {
+        h = mix64(h);
+        uint64_t& slot = sig[h >> (64 - SLOT_BITS)];
+        slot = min(slot, h & VALUE_MASK);
+    };
+
+    size_t i = 0;
+    while (i < text.size()) {
+        if (!isWordByte((unsigned char)text[i])) { i++; continue; }
+        // FNV-1a over the lowercased word
+        uint64_t h = 14695981039346656037ull;
+        for (; i < text.size() && isWordByte((unsigned char)text[i]); ++i) {
+            unsigned char ch = (unsigned char)text[i];
+            if (ch >= 'A' && ch <= 'Z') ch = (unsigned char)(ch - 'A' + 'a');
+            h = (h ^ ch) * 1099511628211ull;
+        }
+        words++;
+        if (words >= 3) addShingle(w0 ^ rotl64(w1, 21) ^ rotl64(h, 42));
+        w0 = w1;
+        w1 = h;
+    }
+    if (words == 0) return false;
+    // too short for a 3-gram: the words themselves stand in
+    if (words == 1) addShingle(w1);
+    else if (words == 2) addShingle(w0 ^ rotl64(w1, 21));
+
+    int firstFilled = 0;
+    while (sig[firstFilled] == ~0ull) firstFilled++;
+    for (int s = SIG_SLOTS - 1, from = firstFilled, distance = firstFilled; s >= 0; --s) {
+        if (sig[s] != ~0ull) {
+            from = s;
+            distance = 0;
+            continue;
+        }
+        distance++;
+        sig[s] = sig[from] | ((uint64_t)distance << (64 - SLOT_BITS));
+    }
+    return true;
+}
+
+// true if the signatures differ in at most maxMisses slots; most bucket mates that
+// are not duplicates give up well before the end
+static bool similarEnough(const uint64_t* a, const uint64_t* b, int maxMisses)
+{
+    int misses = 0;
+    for (int s = 0; s < SIG_SLOTS; s += 8) {
+        for (int k = s; k < s + 8; ++k) misses += a[k] != b[k];
+        if (misses > maxMisses) return false;
+    }
+    return true;
+}
+
+static uint32_t findRoot(vector<uint32_t>& parent, uint32_t x)
+{
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+DedupeResult findNearDuplicates(const vector<Candidate>& candidates, int threads, double threshold)
+{
+    RF_TIMED_SCOPE("dedupe");
+    const size_t n = candidates.size();
+    vector<uint64_t> sigs(n * SIG_SLOTS);
+    vector<uint64_t> bandKeys(n * LSH_BANDS);  // hash of each band's rows, per candidate
+    vector<uint8_t> signedOk(n, 0);
+    parallelFor(n, threads, [&](size_t i, int) {
+        const Candidate& c = candidates[i];
+        string_view text = resumeText(c);
+        const uint64_t* sig = &sigs[i * SIG_SLOTS];
+        if (!signText(text, &sigs[i * SIG_SLOTS])) return;
+        signedOk[i] = 1;
+        for (int band = 0; band < LSH_BANDS; ++band) {
+            uint64_t h = (uint64_t)band;
+            for (int r = 0; r < LSH_ROWS; ++r) h = mix64(h ^ sig[band * LSH_ROWS + r]);
+            bandKeys[i * LSH_BANDS + band] = h;
+        }
+    });
+
+    const int maxMisses = (int)((1.0 - threshold) * SIG_SLOTS);
+    vector<uint32_t> parent(n);
+    iota(parent.begin(), parent.end(), 0u);
+    auto tryJoin = [&](uint32_t a, uint32_t b) {
+        uint32_t ra = findRoot(parent, a), rb = findRoot(parent, b);
+        if (ra == rb) return;
+        if (!similarEnough(&sigs[(size_t)a * SIG_SLOTS], &sigs[(size_t)b * SIG_SLOTS], maxMisses)) return;
+        parent[max(ra, rb)] = min(ra, rb);
+    };
+
+    // per band: sort (band hash, candidate) and compare the members of each run
+    vector<pair<uint64_t, uint32_t>> keys;
+    keys.reserve(n);
+    for (int band = 0; band < LSH_BANDS; ++band) {
+        keys.clear();
+        for (size_t i = 0; i < n; ++i) {
+            if (signedOk[i]) keys.emplace_back(bandKeys[i * LSH_BANDS + band], (uint32_t)i);
+        }
+        sort(keys.begin(), keys.end());
+        for (size_t start = 0; start < keys.size();) {
+            size_t end = start + 1;
+            while (end < keys.size() && keys[end].first == keys[start].first) end++;
+            const size_t m = end - start;
+            if (m <= 8) {
+                for (size_t a = start; a < end; ++a)
+                    for (size_t b = a + 1; b < end; ++b) tryJoin(keys[a].second, keys[b].second);
+            }
+            else {
+                // big buckets come from text many resumes share; comparing neighbours
+                // only keeps them linear, and a pair missed here meets again in
+                // another band
+                for (size_t a = start + 1; a < end; ++a) tryJoin(keys[a - 1].second, keys[a].second);
+            }
+            start = end;
+        }
+    }
+
+    DedupeResult result;
+    result.representative.resize(n);
+    // smallest path per root, then every member points at it
+    vector<uint32_t> best(n, UINT32_MAX);
+    vector<uint32_t> members(n, 0);
+    for (uint32_t i = 0; i < (uint32_t)n; ++i) {
+        uint32_t r = findRoot(parent, i);
+        members[r]++;
+        if (best[r] == UINT32_MAX || spanText(candidates[i], candidates[i].filepath) < spanText(candidates[best[r]], candidates[best[r]].filepath)) best[r] = i;
+    }
+    for (uint32_t i = 0; i < (uint32_t)n; ++i) {
+        uint32_t r = findRoot(parent, i);
+        result.representative[i] = best[r];
+        if (best[r] != i) result.duplicates++;
+        if (r == i && members[r] > 1) result.clusters++;
+    }
+    return result;
+}
@@ -0,0 +1,28 @@
+#ifndef DEDUPE_H
+#define DEDUPE_H
+
+#include "parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Near-duplicate resumes: the same resume re-submitted under another file name,
+// possibly with small edits. Each resume gets a MinHash signature over its word
+// 3-grams (one-permutation hashing, so one hash per 3-gram); LSH banding puts
+// resumes that agree on a whole band in the same bucket, and only bucket mates are
+// compared, so the cost grows with the number of resumes rather than with pairs.
+// Resumes whose signatures agree on at least `threshold` of their slots (the
+// estimated Jaccard similarity of their 3-gram sets) end up in one cluster.
+struct DedupeResult {
+    vector<uint32_t> representative;    // per candidate: the cluster member that is kept
+    size_t duplicates = 0;              // candidates that are not their own representative
+    size_t clusters = 0;                // clusters with more than one member
+};
+
+// The member with the smallest file path represents its cluster, so the choice does
+// not depend on directory order. Candidates with no words are never clustered.
+DedupeResult findNearDuplicates(const vector<Candidate>& candidates, int threads, double threshold = 0.8);
+
+#endif // DEDUPE_H
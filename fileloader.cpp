@@ -0,0 +1,369 @@
+#include "fileloader.h"
+#include "stats.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if RF_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+
+static inline size_t reserveFor(uint64_t size, const string& path, size_t spare)
+{
+    return (size_t)size + path.size() + spare;
+}
+
+#ifdef _WIN32
+
+static void loadOne(const string& path, size_t spare, string& out, FileLoadError& error)
+{
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) {
+        error = LOAD_CANNOT_OPEN;
+        return;
+    }
+    RF_STAT_ADD(STAT_FILES_OPENED, 1);
+    in.seekg(0, ios::end);
+    streamoff size = in.tellg();
+    in.seekg(0, ios::beg);
+    if (size < 0 || (uint64_t)size > MAX_LOAD_SIZE) {
+        error = LOAD_TOO_LARGE;
+        return;
+    }
+    out.clear();
+    out.reserve(reserveFor((uint64_t)size, path, spare));
+    if (size > 0) {
+        out.resize((size_t)size);
+        in.read(&out[0], size);
+        out.resize((size_t)in.gcount());
+    }
+    error = LOAD_OK;
+}
+
+#else
+
+static void loadOne(const string& path, size_t spare, string& out, FileLoadError& error)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = LOAD_CANNOT_OPEN;
+        return;
+    }
+    RF_STAT_ADD(STAT_FILES_OPENED, 1);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        error = LOAD_READ_FAILED;
+        return;
+    }
+    if ((uint64_t)st.st_size > MAX_LOAD_SIZE) {
+        close(fd);
+        error = LOAD_TOO_LARGE;
+        return;
+    }
+    out.clear();
+    out.reserve(reserveFor((uint64_t)st.st_size, path, spare));
+    out.resize((size_t)st.st_size);
+    size_t got = 0;
+    while (got < out.size()) {
+        ssize_t n = pread(fd, &out[got], out.size() - got, (off_t)got);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;      // shrank meanwhile: keep what was there
+        got += (size_t)n;
+    }
+    out.resize(got);
+    close(fd);
+    error = LOAD_OK;
+}
+
+#endif
+
+#if RF_IO_URING
+
+// One submission / completion ring per thread, set up on first use. The kernel
+// interface is used directly (no liburing): mmap the rings, fill SQEs, publish the
+// tail with a release store, read completions after an acquire load of their tail.
+struct Ring {
+    int fd = -1;
+    unsigned entries = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned* sqArray = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    void* ringMap = nullptr;
+    size_t ringSize = 0;
+    void* cqMap = nullptr;      // only without IORING_FEAT_SINGLE_MMAP
+    size_t cqSize = 0;
+    void* sqeMap = nullptr;
+    size_t sqeSize = 0;
+
+    Ring() = default;
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+    ~Ring()
+    {
+        if (sqeMap) munmap(sqeMap, sqeSize);
+        if (cqMap) munmap(cqMap, cqSize);
+        if (ringMap) munmap(ringMap, ringSize);
+        if (fd >= 0) close(fd);
+    }
+};
+
+static const unsigned RING_ENTRIES = 128;      // two requests per file in flight
+static const size_t URING_BATCH = RING_ENTRIES / 2;
+
+// cleared for good the first time a ring cannot be set up
+static atomic<bool> uringAvailable{ true };
+
+// True if the kernel runs every opcode the loader submits. Rings exist since 5.1,
+// but opens, statx, plain reads and closes only arrived in 5.6 (with the probe
+// itself): on 5.1 - 5.5 the ring sets up fine and then fails every open.
+static bool ringSupportsLoader(int fd)
+{
+    const unsigned opCount = 256;
+    vector<char> buf(sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = (io_uring_probe*)buf.data();
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, opCount) < 0) return false;
+    for (unsigned op : { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE }) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    }
+    return true;
+}
+
+static bool setupRing(Ring& r)
+{
+    io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = (int)syscall(__NR_io_uring_setup, RING_ENTRIES, &p);
+    if (fd < 0) return false;
+    r.fd = fd;
+    r.entries = p.sq_entries;
+    if (!ringSupportsLoader(fd)) return false;
+
+    r.ringSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    const size_t cqBytes = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && cqBytes > r.ringSize) r.ringSize = cqBytes;
+    void* ring = mmap(nullptr, r.ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring == MAP_FAILED) return false;
+    r.ringMap = ring;
+    char* cq = (char*)ring;
+    if (!single) {
+        r.cqSize = cqBytes;
+        void* m = mmap(nullptr, r.cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (m == MAP_FAILED) return false;
+        r.cqMap = m;
+        cq = (char*)m;
+    }
+    r.sqeSize = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, r.sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    r.sqeMap = sqes;
+
+    char* sq = (char*)ring;
+    r.sqHead = (unsigned*)(sq + p.sq_off.head);
+    r.sqTail = (unsigned*)(sq + p.sq_off.tail);
+    r.sqMask = *(unsigned*)(sq + p.sq_off.ring_mask);
+    r.sqArray = (unsigned*)(sq + p.sq_off.array);
+    r.sqes = (io_uring_sqe*)sqes;
+    r.cqHead = (unsigned*)(cq + p.cq_off.head);
+    r.cqTail = (unsigned*)(cq + p.cq_off.tail);
+    r.cqMask = *(unsigned*)(cq + p.cq_off.ring_mask);
+    r.cqes = (io_uring_cqe*)(cq + p.cq_off.cqes);
+    return true;
+}
+
+// this thread's ring, or null if io_uring cannot be used
+static Ring* threadRing()
+{
+    if (!uringAvailable.load(memory_order_relaxed)) return nullptr;
+    thread_local unique_ptr<Ring> ring;
+    thread_local bool failed = false;
+    if (ring) return ring.get();
+    if (failed) return nullptr;
+    unique_ptr<Ring> r(new Ring());
+    if (!setupRing(*r)) {
+        // ENOSYS / EPERM / a kernel without the opcodes will not change; other
+        // threads need not try again
+        failed = true;
+        uringAvailable.store(false, memory_order_relaxed);
+        return nullptr;
+    }
+    ring = move(r);
+    return ring.get();
+}
+
+// user_data: file index and which request of that file completed
+enum : uint64_t { OP_OPEN, OP_STATX, OP_READ, OP_CLOSE, OP_BITS = 2 };
+
+static io_uring_sqe* queueSqe(Ring& r, unsigned& tail, uint64_t file, uint64_t op)
+{
+    const unsigned idx = tail & r.sqMask;
+    io_uring_sqe* sqe = &r.sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = (file << OP_BITS) | op;
+    r.sqArray[idx] = idx;
+    tail++;
+    return sqe;
+}
+
+// Publishes `count` queued SQEs and waits until as many completions have been
+// handed to onComplete(user_data, res). False if the ring itself failed.
+template <class F>
+static bool submitAndReap(Ring& r, unsigned tail, unsigned count, F&& onComplete)
+{
+    __atomic_store_n(r.sqTail, tail, __ATOMIC_RELEASE);
+    unsigned toSubmit = count, reaped = 0;
+    while (reaped < count) {
+        RF_STAT_ADD(STAT_IO_URING_ENTERS, 1);
+        int ret = (int)syscall(__NR_io_uring_enter, r.fd, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+            return false;
+        }
+        toSubmit -= min((unsigned)ret, toSubmit);
+
+        unsigned head = *r.cqHead;
+        const unsigned cqTail = __atomic_load_n(r.cqTail, __ATOMIC_ACQUIRE);
+        for (; head != cqTail; ++head) {
+            const io_uring_cqe& cqe = r.cqes[head & r.cqMask];
+            onComplete(cqe.user_data, cqe.res);
+            reaped++;
+        }
+        __atomic_store_n(r.cqHead, head, __ATOMIC_RELEASE);
+    }
+    return true;
+}
+
+// Up to URING_BATCH files: every open + statx, then every read + close. False if the
+// ring failed; files not finished then are left for the fallback.
+static bool loadBatchUring(Ring& r, const string* paths, size_t count, size_t spare, string* data, FileLoadError* error, uint8_t* done)
+{
+    static thread_local vector<int> fds;
+    static thread_local vector<struct statx> stats;
+    fds.assign(count, -1);
+    stats.resize(count);
+    vector<int> statResult(count, 0);
+
+    unsigned tail = *r.sqTail;
+    for (size_t k = 0; k < count; ++k) {
+        io_uring_sqe* open = queueSqe(r, tail, k, OP_OPEN);
+        open->opcode = IORING_OP_OPENAT;
+        open->fd = AT_FDCWD;
+        open->addr = (uint64_t)(uintptr_t)paths[k].c_str();
+        open->open_flags = O_RDONLY | O_CLOEXEC;
+        io_uring_sqe* st = queueSqe(r, tail, k, OP_STATX);
+        st->opcode = IORING_OP_STATX;
+        st->fd = AT_FDCWD;
+        st->addr = (uint64_t)(uintptr_t)paths[k].c_str();
+        st->len = STATX_SIZE;
+        st->off = (uint64_t)(uintptr_t)&stats[k];   // addr2: the statx buffer
+    }
+    bool unsupported = false;
+    bool ok = submitAndReap(r, tail, (unsigned)(2 * count), [&](uint64_t user, int res) {
+        const size_t k = (size_t)(user >> OP_BITS);
+        // the opcode itself was refused, whatever the probe said: not the file's fault
+        if (res == -EINVAL || res == -EOPNOTSUPP) unsupported = true;
+        if ((user & 3) == OP_OPEN) fds[k] = res;
+        else statResult[k] = res;
+    });
+    if (!ok || unsupported) {
+        for (int fd : fds) if (fd >= 0) close(fd);
+        return false;
+    }
+
+    tail = *r.sqTail;
+    unsigned queued = 0;
+    for (size_t k = 0; k < count; ++k) {
+        if (fds[k] < 0) {
+            error[k] = LOAD_CANNOT_OPEN;
+            done[k] = 1;
+            continue;
+        }
+        RF_STAT_ADD(STAT_FILES_OPENED, 1);
+        const uint64_t size = statResult[k] == 0 ? stats[k].stx_size : 0;
+        if (statResult[k] != 0 || size > MAX_LOAD_SIZE) {
+            error[k] = statResult[k] != 0 ? LOAD_READ_FAILED : LOAD_TOO_LARGE;
+            done[k] = 1;
+        }
+        else {
+            data[k].clear();
+            data[k].reserve(reserveFor(size, paths[k], spare));
+            data[k].resize((size_t)size);
+            error[k] = LOAD_OK;
+            if (size > 0) {
+                io_uring_sqe* rd = queueSqe(r, tail, k, OP_READ);
+                rd->opcode = IORING_OP_READ;
+                rd->fd = fds[k];
+                rd->addr = (uint64_t)(uintptr_t)&data[k][0];
+                rd->len = (unsigned)size;
+                rd->off = 0;
+                // the close runs even if the read fails or comes up short
+                rd->flags = IOSQE_IO_HARDLINK;
+                queued++;
+            }
+        }
+        io_uring_sqe* cl = queueSqe(r, tail, k, OP_CLOSE);
+        cl->opcode = IORING_OP_CLOSE;
+        cl->fd = fds[k];
+        queued++;
+    }
+    ok = submitAndReap(r, tail, queued, [&](uint64_t user, int res) {
+        const size_t k = (size_t)(user >> OP_BITS);
+        if ((user & 3) != OP_READ) return;
+        if (res < 0) {
+            error[k] = LOAD_READ_FAILED;
+            data[k].clear();
+        }
+        else {
+            // shorter than stat said: the file shrank meanwhile, keep what was there
+            data[k].resize((size_t)res);
+        }
+        done[k] = 1;
+    });
+    if (!ok) return false;
+    for (size_t k = 0; k < count; ++k) done[k] = 1;
+    return true;
+}
+
+#endif
+
+void loadFiles(const string* paths, size_t count, size_t spare, string* data, FileLoadError* error)
+{
+    RF_TIMED_SCOPE("read files");
+    vector<uint8_t> done(count, 0);
+#if RF_IO_URING
+    if (Ring* ring = threadRing()) {
+        for (size_t first = 0; first < count; first += URING_BATCH) {
+            const size_t n = min(URING_BATCH, count - first);
+            if (!loadBatchUring(*ring, paths + first, n, spare, data + first, error + first, &done[first])) {
+                uringAvailable.store(false, memory_order_relaxed);
+                break;
+            }
+        }
+    }
+#endif
+    for (size_t k = 0; k < count; ++k) {
+        if (!done[k]) loadOne(paths[k], spare, data[k], error[k]);
+        if (error[k] == LOAD_OK) RF_STAT_ADD(STAT_BYTES_READ, data[k].size());
+    }
+}
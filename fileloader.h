@@ -0,0 +1,41 @@
+#ifndef FILELOADER_H
+#define FILELOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Whole-file reads in batches, for folders of many small files where ingest time goes
+// to open / stat / read / close syscalls rather than to parsing. On Linux a batch goes
+// through io_uring: the opens and stats of every file are submitted together, then
+// every read (each followed by its close), so a batch costs two trips into the
+// kernel instead of four per file. Without io_uring (kernels before 5.6, seccomp, other
+// systems, or RF_IO_URING=0 at build time) each file is read with open / fstat /
+// pread / close, or an ifstream on Windows.
+#ifndef RF_IO_URING
+#if defined(__linux__)
+#define RF_IO_URING 1
+#else
+#define RF_IO_URING 0
+#endif
+#endif
+
+enum FileLoadError : uint8_t {
+    LOAD_OK,
+    LOAD_CANNOT_OPEN,
+    LOAD_TOO_LARGE,         // over MAX_LOAD_SIZE
+    LOAD_READ_FAILED,
+};
+
+// larger files are refused; parsed text uses 32-bit spans
+const uint64_t MAX_LOAD_SIZE = UINT32_MAX / 2;
+
+// Reads paths[k] into data[k] for every k < count, replacing what was there, and
+// sets error[k]. Each buffer gets room past the file's end for its path and `spare`
+// more bytes (what the parser appends), so appending does not reallocate. Files are
+// independent: one that fails does not affect the others.
+void loadFiles(const string* paths, size_t count, size_t spare, string* data, FileLoadError* error);
+
+#endif // FILELOADER_H
@@ -1,82 +1,648 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <filesystem>
-#include <iomanip>
-
-#include "parser.h"
-#include "scorer.h"
-#include "report.h"
-
-using namespace std;
-namespace fs = std::filesystem;
-
-int main()
-{
-    cout << "Resume Filter - Console version\n";
-    cout << "Enter path to folder containing resume .txt files: ";
-    string resumes_folder;
-    getline(cin, resumes_folder);
-
-    if (resumes_folder.empty()) {
-        cout << "No folder provided. Exiting.\n";
-        return 1;
-    }
-
-    cout << "Enter path to job description file (.txt): ";
-    string job_file;
-    getline(cin, job_file);
-
-    if (job_file.empty()) {
-        cout << "No job description file provided. Exiting.\n";
-        return 1;
-    }
-
-    // 1) Read resumes
-    vector<Candidate> candidates = parseResumesFromFolder(resumes_folder);
-    if (candidates.empty()) {
-        cout << "No resumes found in folder: " << resumes_folder << "\n";
-        return 1;
-    }
-
-    // 2) Read job description
-    Job job = parseJobDescription(job_file);
-
-    // 3) Score candidates
-    scoreAllCandidates(candidates, job);
-
-    // 4) Print results to console
-    cout << "\nResults:\n";
-    cout << left << setw(30) << "Name"
-        << setw(10) << "Grade"
-        << setw(10) << "Score"
-        << "Matched Skills\n";
-    cout << string(80, '-') << "\n";
-
-    for (auto& c : candidates) {
-        cout << left << setw(30) << c.name
-            << setw(10) << c.grade
-            << setw(10) << fixed << setprecision(1) << c.score;
-
-        // show up to first 4 matched skills
-        string ms;
-        for (size_t i = 0; i < c.matchedSkills.size() && i < 4; ++i) {
-            if (i) ms += ", ";
-            ms += c.matchedSkills[i];
-        }
-        cout << ms << "\n";
-    }
-
-    // 5) Generate report (selected candidates)
-    string report_path = "selected_candidates_report.txt";
-    bool ok = writeReport(report_path, candidates, job);
-    if (ok) {
-        cout << "\nReport written to: " << report_path << "\n";
-    }
-    else {
-        cout << "\nFailed to write report.\n";
-    }
-
-    cout << "Done.\n";
-    return 0;
+#include <iostream>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+
+#include "parser.h"
+#include "scorer.h"
+#include "report.h"
+#include "threadpool.h"
+#include "snapshot.h"
+#include "ranking.h"
+#include "stats.h"
+#include "allocstats.h"
+#include "server.h"
+#include "dedupe.h"
+#include "shard.h"
+#include "bundle.h"
+#include "watch.h"
+#include "utils.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// command-line switches; folder and job file are asked for interactively unless given
+struct Options {
+    string executable;      // argv[0], to start shard workers
+    string resumesFolder;   // skip the folder prompt; a bundle file works too
+    string jobFile;         // skip the job file prompt
+    int threads = 1;        // parser threads, 0 = one per core
+    string dictPath;        // known skill / certification names, built-ins if empty
+    string loadSnapshotPath; // read candidates from this snapshot instead of a folder
+    string saveSnapshotPath; // write the parsed candidates here
+    string cachePath;       // incremental ingest cache
+    string batchJobsFolder; // score every job file in this folder instead of one job
+    size_t top = 0;         // keep only the best N candidates while streaming, 0 = keep all
+    bool stats = false;     // print stage timings and counters at the end
+    string tracePath;       // Chrome trace-event JSON of the timed stages
+    bool profileSet = false; // score every job with `profile`, whatever its file says
+    ScoringProfile profile = PROFILE_ENGINEERING;
+    string serveSocket;     // run as a daemon answering job queries on this Unix socket
+    int reloadSeconds = 5;  // --serve: how often to look for changed resumes
+    bool dedupe = false;    // score near-duplicate resumes once, under one candidate
+    double dedupeThreshold = 0.8; // estimated 3-gram Jaccard similarity that counts as a duplicate
+    uint32_t shards = 0;    // coordinator: split the folder over this many worker processes
+    uint32_t shard = 0;     // worker: score shard `shard` of `shardCount` ...
+    uint32_t shardCount = 0;
+    string shardOut;        // ... and write its result here instead of a report
+    string packPath;        // pack the resume folder into this bundle and stop
+    bool watch = false;     // keep the report current as resumes are added, changed or removed
+};
+
+static void printUsage()
+{
+    cout << "Usage: resume_filter [--threads N] [--dict FILE] [--cache FILE] [--load-snapshot FILE | --save-snapshot FILE]\n";
+    cout << "                     [--batch-jobs FOLDER | --top N] [--stats] [--trace FILE]\n";
+    cout << "                     [--profile engineering|intern|management] [--serve SOCKET [--reload-interval S]]\n";
+    cout << "                     [--dedupe] [--dedupe-threshold X] [--shards N | --shard I/N --shard-out FILE]\n";
+    cout << "                     [--resumes FOLDER] [--job FILE] [--pack FILE] [--watch]\n";
+    cout << "  --resumes FOLDER       resume folder or bundle (instead of asking for it)\n";
+    cout << "  --job FILE             job description file (instead of asking for it)\n";
+    cout << "  --threads N            parse resumes on N threads (0 = all cores, default 1)\n";
+    cout << "  --dict FILE            load known skill / certification names from FILE\n";
+    cout << "  --cache FILE           keep parse results in FILE; later runs only parse new or changed resumes\n";
+    cout << "  --load-snapshot FILE   take candidates from a snapshot instead of a resume folder\n";
+    cout << "  --save-snapshot FILE   save the parsed candidates to FILE for later runs\n";
+    cout << "  --batch-jobs FOLDER    score all job .txt files in FOLDER and write score_matrix.csv\n";
+    cout << "  --top N                score resumes as they are parsed and keep only the best N\n";
+    cout << "  --profile NAME         score with the NAME weights instead of each job's \"Profile:\" line\n";
+    cout << "  --dedupe               score near-duplicate resumes once and list the copies under one candidate\n";
+    cout << "  --dedupe-threshold X   similarity (0-1, default 0.8) above which --dedupe folds two resumes\n";
+    cout << "  --serve SOCKET         answer job queries on a Unix socket instead of scoring one job\n";
+    cout << "                         (--threads sets the query workers, --top the results per query)\n";
+    cout << "  --reload-interval S    --serve: re-parse the folder when its files change, checked\n";
+    cout << "                         every S seconds (default 5, 0 = never)\n";
+    cout << "  --shards N             with --top: split the folder over N worker processes and merge\n";
+    cout << "                         their best N (--threads applies to each worker)\n";
+    cout << "  --shard I/N            with --top and --shard-out: score only shard I (0-based) of N\n";
+    cout << "  --shard-out FILE       write the shard's best candidates and grade counts to FILE\n";
+    cout << "  --watch                keep watching the folder and update the report as resumes change\n";
+    cout << "  --pack FILE            pack the resume folder's .txt files into bundle FILE and exit\n";
+    cout << "  --stats                print per-stage timings and counters at the end\n";
+    cout << "  --trace FILE           write a Chrome trace-event file of the timed stages\n";
+}
+
+static bool parseArgs(int argc, char* argv[], Options& opt)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        uint64_t n = 0;
+        if (arg == "--threads" && i + 1 < argc) {
+            if (!parseUnsigned(argv[++i], INT_MAX, n)) return false;
+            opt.threads = n == 0 ? defaultThreadCount() : (int)n;
+        }
+        else if (arg == "--dict" && i + 1 < argc) {
+            opt.dictPath = argv[++i];
+        }
+        else if (arg == "--cache" && i + 1 < argc) {
+            opt.cachePath = argv[++i];
+        }
+        else if (arg == "--batch-jobs" && i + 1 < argc) {
+            opt.batchJobsFolder = argv[++i];
+        }
+        else if (arg == "--load-snapshot" && i + 1 < argc) {
+            opt.loadSnapshotPath = argv[++i];
+        }
+        else if (arg == "--save-snapshot" && i + 1 < argc) {
+            opt.saveSnapshotPath = argv[++i];
+        }
+        else if (arg == "--profile" && i + 1 < argc) {
+            if (!profileFromName(argv[++i], opt.profile)) {
+                cout << "Unknown scoring profile: " << argv[i] << "\n";
+                return false;
+            }
+            opt.profileSet = true;
+        }
+        else if (arg == "--serve" && i + 1 < argc) {
+            opt.serveSocket = argv[++i];
+        }
+        else if (arg == "--reload-interval" && i + 1 < argc) {
+            if (!parseUnsigned(argv[++i], INT_MAX, n)) return false;
+            opt.reloadSeconds = (int)n;
+        }
+        else if (arg == "--dedupe") {
+            opt.dedupe = true;
+        }
+        else if (arg == "--dedupe-threshold" && i + 1 < argc) {
+            char* end = nullptr;
+            opt.dedupeThreshold = strtod(argv[++i], &end);
+            if (*end != '\0' || !(opt.dedupeThreshold > 0.0 && opt.dedupeThreshold <= 1.0)) return false;
+            opt.dedupe = true;
+        }
+        else if (arg == "--resumes" && i + 1 < argc) {
+            opt.resumesFolder = argv[++i];
+        }
+        else if (arg == "--job" && i + 1 < argc) {
+            opt.jobFile = argv[++i];
+        }
+        else if (arg == "--shards" && i + 1 < argc) {
+            if (!parseUnsigned(argv[++i], UINT32_MAX, n) || n == 0) return false;
+            opt.shards = (uint32_t)n;
+        }
+        else if (arg == "--shard" && i + 1 < argc) {
+            unsigned shard = 0, count = 0;
+            char extra = 0;
+            if (sscanf(argv[++i], "%u/%u%c", &shard, &count, &extra) != 2 || count == 0 || shard >= count) return false;
+            opt.shard = shard;
+            opt.shardCount = count;
+        }
+        else if (arg == "--shard-out" && i + 1 < argc) {
+            opt.shardOut = argv[++i];
+        }
+        else if (arg == "--pack" && i + 1 < argc) {
+            opt.packPath = argv[++i];
+        }
+        else if (arg == "--watch") {
+            opt.watch = true;
+        }
+        else if (arg == "--stats") {
+            opt.stats = true;
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            opt.tracePath = argv[++i];
+        }
+        else if (arg == "--top" && i + 1 < argc) {
+            if (!parseUnsigned(argv[++i], SIZE_MAX, n) || n == 0) return false;
+            opt.top = (size_t)n;
+        }
+        else {
+            return false;
+        }
+    }
+    const bool shardWorker = opt.shardCount > 0 || !opt.shardOut.empty();
+    // packing reads the folder and writes the bundle, nothing is scored
+    if (!opt.packPath.empty() && (!opt.serveSocket.empty() || !opt.loadSnapshotPath.empty() || opt.shards > 0 || shardWorker)) {
+        cout << "--pack cannot be combined with --serve, --load-snapshot or sharding\n";
+        return false;
+    }
+    // watching keeps one job's ranking of one folder current, nothing else
+    if (opt.watch && (!opt.serveSocket.empty() || !opt.loadSnapshotPath.empty() || !opt.saveSnapshotPath.empty()
+        || !opt.batchJobsFolder.empty() || opt.top > 0 || opt.dedupe || opt.shards > 0 || shardWorker || !opt.packPath.empty())) {
+        cout << "--watch cannot be combined with --serve, snapshots, --batch-jobs, --top, --dedupe, sharding or --pack\n";
+        return false;
+    }
+    // the daemon re-parses the folder on reload and answers one job per query
+    if (!opt.serveSocket.empty()) {
+        if (!opt.loadSnapshotPath.empty() || !opt.saveSnapshotPath.empty() || !opt.batchJobsFolder.empty() || opt.shards > 0 || shardWorker) {
+            cout << "--serve cannot be combined with --load-snapshot, --save-snapshot, --batch-jobs or sharding\n";
+            return false;
+        }
+        return true;
+    }
+    // shards stream their part of the folder through a top-K, like --top
+    if (opt.shards > 0 || shardWorker) {
+        if (opt.top == 0 || !opt.loadSnapshotPath.empty() || (opt.shards > 0 && shardWorker)) {
+            cout << "--shards and --shard need --top and a resume folder, and exclude each other\n";
+            return false;
+        }
+        if (shardWorker && (opt.shardCount == 0 || opt.shardOut.empty())) {
+            cout << "--shard and --shard-out go together\n";
+            return false;
+        }
+    }
+    // top-K drops candidates as it goes, so there is no full pool to cache, save or batch
+    if (opt.top > 0 && (!opt.cachePath.empty() || !opt.saveSnapshotPath.empty() || !opt.batchJobsFolder.empty() || opt.dedupe)) {
+        cout << "--top cannot be combined with --cache, --save-snapshot, --batch-jobs or --dedupe\n";
+        return false;
+    }
+    return true;
+}
+
+static void startStats(const Options& opt)
+{
+    if (!opt.stats && opt.tracePath.empty()) return;
+#if RF_STATS
+    statsStart(!opt.tracePath.empty());
+#else
+    cout << "Stats were compiled out (built with RF_STATS=0); --stats and --trace are ignored.\n";
+#endif
+}
+
+// prints / writes the requested stats on the way out and passes the exit code through
+static int finishRun(const Options& opt, int rc)
+{
+#if RF_STATS
+    if (opt.stats) printStats(cout);
+    if (!opt.tracePath.empty()) {
+        if (writeTrace(opt.tracePath)) cout << "Trace written to: " << opt.tracePath << "\n";
+        else cout << "Failed to write trace: " << opt.tracePath << "\n";
+    }
+#else
+    (void)opt;
+#endif
+#if RF_ALLOC_STATS
+    printAllocStats(cout);
+#endif
+    return rc;
+}
+
+// job file with the --profile override applied
+static Job loadJob(const Options& opt, const string& path)
+{
+    Job job = parseJobDescription(path);
+    if (opt.profileSet) job.profile = opt.profile;
+    return job;
+}
+
+// --batch-jobs: every job file in the folder against the whole pool in one pass
+static int runBatch(const Options& opt, const vector<Candidate>& candidates)
+{
+    const string& jobsFolder = opt.batchJobsFolder;
+    vector<string> jobFiles;
+    try {
+        for (auto& ent : fs::directory_iterator(jobsFolder)) {
+            if (ent.is_regular_file() && ent.path().extension() == ".txt") jobFiles.push_back(ent.path().string());
+        }
+    }
+    catch (const std::exception& e) {
+        cout << "Error reading folder: " << e.what() << "\n";
+    }
+    if (jobFiles.empty()) {
+        cout << "No job descriptions found in folder: " << jobsFolder << "\n";
+        return 1;
+    }
+    sort(jobFiles.begin(), jobFiles.end());
+
+    vector<Job> jobs;
+    for (auto& f : jobFiles) jobs.push_back(loadJob(opt, f));
+    ScoreMatrix m = scoreJobsBatch(candidates, jobs);
+
+    cout << "\nBest candidate per job:\n";
+    cout << left << setw(40) << "Job" << setw(30) << "Name" << "Score\n";
+    cout << string(80, '-') << "\n";
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        size_t best = 0;
+        for (size_t i = 1; i < m.candidateCount; ++i) {
+            if (m.scores[j * m.candidateCount + i] > m.scores[j * m.candidateCount + best]) best = i;
+        }
+        cout << left << setw(40) << fs::path(jobFiles[j]).filename().string()
+            << setw(30) << spanText(candidates[best], candidates[best].name)
+            << fixed << setprecision(1) << m.scores[j * m.candidateCount + best] << "\n";
+    }
+
+    string matrix_path = "score_matrix.csv";
+    if (writeScoreMatrix(matrix_path, candidates, jobFiles, m)) {
+        cout << "\nScore matrix written to: " << matrix_path << "\n";
+    }
+    else {
+        cout << "\nFailed to write score matrix.\n";
+    }
+    cout << "Done.\n";
+    return 0;
+}
+
+static void printResults(const CandidatePool& pool)
+{
+    RF_TIMED_SCOPE("print results");
+    RF_ALLOC_STAGE(ALLOC_REPORT);
+    cout << "\nResults:\n";
+    cout << left << setw(30) << "Name"
+        << setw(10) << "Grade"
+        << setw(10) << "Score"
+        << "Matched Skills\n";
+    cout << string(80, '-') << "\n";
+
+    for (size_t r = 0; r < poolSize(pool); ++r) {
+        const size_t c = entryAtRank(pool, r);
+        cout << left << setw(30) << poolText(pool, pool.name[c])
+            << setw(10) << pool.grade[c]
+            << setw(10) << fixed << setprecision(1) << pool.score[c];
+
+        // show up to first 4 matched skills
+        string ms;
+        const uint32_t first = pool.matchedSkillStart[c];
+        for (uint32_t i = first; i < pool.matchedSkillStart[c + 1] && i < first + 4; ++i) {
+            if (i != first) ms += ", ";
+            ms += skillName(pool.matchedSkillIds[i]);
+        }
+        cout << ms << "\n";
+    }
+}
+
+// prints and reports the best candidates of a streamed run, best first
+static int finishRanked(vector<Candidate>&& best, const Job& job, const GradeCounts& counts, ScoreSketch&& sketch)
+{
+    CandidatePool ranked = poolFromCandidates(move(best));
+    ranked.sketch = move(sketch);
+    printResults(ranked);
+
+    string report_path = "selected_candidates_report.txt";
+    if (writeReport(report_path, ranked, job, &counts)) {
+        cout << "\nReport written to: " << report_path << "\n";
+    }
+    else {
+        cout << "\nFailed to write report.\n";
+    }
+    cout << "Done.\n";
+    return 0;
+}
+
+// --top: score each resume as soon as it is parsed and keep only the best N, so memory
+// stays bounded by N rather than by the size of the folder
+static int runTopK(const Options& opt, const string& resumesFolder, const string& jobFile)
+{
+    Job job = loadJob(opt, jobFile);
+
+    const int workers = opt.threads > 1 ? opt.threads : 1;
+    vector<JobScorer> scorers(workers);
+    vector<TopK> tops(workers);
+    vector<ScoreSketch> sketches(workers);     // every resume streamed, not just the kept ones
+    for (int w = 0; w < workers; ++w) {
+        prepareScorer(scorers[w], job);
+        tops[w].k = opt.top;
+        startSketch(sketches[w], job);
+        scorers[w].sketch = &sketches[w];
+    }
+
+    if (!opt.loadSnapshotPath.empty()) {
+        vector<Candidate> loaded;
+        if (!loadSnapshot(opt.loadSnapshotPath, loaded)) return 1;
+        if (loaded.empty()) {
+            cout << "Snapshot holds no candidates: " << opt.loadSnapshotPath << "\n";
+            return 1;
+        }
+        for (auto& c : loaded) {
+            scoreCandidate(scorers[0], c);
+            offerCandidate(tops[0], move(c));
+        }
+    }
+    else {
+        RF_TIMED_SCOPE("stream and rank");
+        IngestOptions ingest;
+        ingest.threads = workers;
+        if (opt.shardCount > 0) {
+            ingest.shard = opt.shard;
+            ingest.shardCount = opt.shardCount;
+        }
+        streamResumesFromFolder(resumesFolder, ingest, [&](Candidate&& c, int worker) {
+            scoreCandidate(scorers[worker], c);
+            offerCandidate(tops[worker], move(c));
+        });
+    }
+    for (int w = 1; w < workers; ++w) {
+        mergeTopK(tops[0], move(tops[w]));
+        mergeSketch(sketches[0], sketches[w]);
+    }
+
+    // shard worker: the coordinator merges and reports; an empty shard is not an error
+    if (!opt.shardOut.empty()) {
+        ShardResult r;
+        r.shard = opt.shard;
+        r.shardCount = opt.shardCount;
+        r.counts = tops[0].counts;
+        r.best = takeRanked(tops[0]);
+        r.sketch = move(sketches[0]);
+        if (!writeShardResult(opt.shardOut, r)) return 1;
+        cout << "Shard " << opt.shard << "/" << opt.shardCount << ": " << r.counts.total << " resumes, best "
+            << r.best.size() << " written to " << opt.shardOut << endl;
+        return 0;
+    }
+
+    if (tops[0].counts.total == 0) {
+        cout << "No resumes found in folder: " << resumesFolder << "\n";
+        return 1;
+    }
+    GradeCounts counts = tops[0].counts;
+    return finishRanked(takeRanked(tops[0]), job, counts, move(sketches[0]));
+}
+
+// --shards: runs this program once per shard (--shard I/N) and merges what the workers
+// write. Each shard result holds that shard's best N, so the best N overall are among
+// them; they are rescored here for their matched skills and certifications.
+static int runSharded(const Options& opt, const string& resumesFolder, const string& jobFile)
+{
+    Job job = loadJob(opt, jobFile);
+
+    // a fresh folder for the shard results
+    error_code ec;
+    const fs::path tempRoot = fs::temp_directory_path(ec);
+    fs::path dir;
+    for (uint64_t salt = (uint64_t)chrono::steady_clock::now().time_since_epoch().count();; ++salt) {
+        dir = tempRoot / ("resume_filter_shards_" + to_string(salt % 1000000007));
+        if (fs::create_directory(dir, ec)) break;
+        if (ec) {
+            cout << "Cannot create a folder for shard results in " << tempRoot.string() << "\n";
+            return 1;
+        }
+    }
+
+    vector<vector<string>> commands;
+    vector<string> outputs;
+    for (uint32_t i = 0; i < opt.shards; ++i) {
+        outputs.push_back((dir / ("shard_" + to_string(i) + ".bin")).string());
+        vector<string> cmd = { opt.executable, "--resumes", resumesFolder, "--job", jobFile,
+            "--top", to_string(opt.top), "--threads", to_string(opt.threads),
+            "--shard", to_string(i) + "/" + to_string(opt.shards), "--shard-out", outputs.back() };
+        if (!opt.dictPath.empty()) cmd.insert(cmd.end(), { "--dict", opt.dictPath });
+        if (opt.profileSet) cmd.insert(cmd.end(), { "--profile", profileWeights(opt.profile).name });
+        commands.push_back(move(cmd));
+    }
+
+    int rc = 0;
+    GradeCounts counts;
+    ScoreSketch sketch;
+    startSketch(sketch, job);
+    vector<Candidate> best;
+    {
+        RF_TIMED_SCOPE("run shards");
+        if (!runProcesses(commands)) {
+            cout << "A shard worker failed\n";
+            rc = 1;
+        }
+    }
+    JobScorer scorer;
+    prepareScorer(scorer, job);
+    for (uint32_t i = 0; i < opt.shards && rc == 0; ++i) {
+        ShardResult r;
+        if (!readShardResult(outputs[i], r)) {
+            rc = 1;
+            break;
+        }
+        if (r.shard != i || r.shardCount != opt.shards) {
+            cout << "Shard result " << outputs[i] << " is for shard " << r.shard << "/" << r.shardCount << "\n";
+            rc = 1;
+            break;
+        }
+        mergeGradeCounts(counts, r.counts);
+        mergeSketch(sketch, r.sketch);
+        for (auto& c : r.best) {
+            scoreCandidate(scorer, c);
+            best.push_back(move(c));
+        }
+    }
+    fs::remove_all(dir, ec);
+    if (rc != 0) return rc;
+
+    if (counts.total == 0) {
+        cout << "No resumes found in folder: " << resumesFolder << "\n";
+        return 1;
+    }
+    sort(best.begin(), best.end(), rankBefore);
+    if (best.size() > opt.top) best.resize(opt.top);
+    return finishRanked(move(best), job, counts, move(sketch));
+}
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    opt.executable = argv[0];
+    if (!parseArgs(argc, argv, opt)) {
+        printUsage();
+        return 1;
+    }
+
+    // every exit from here on goes through finishRun, so a failed run still reports
+    startStats(opt);
+    if (!opt.dictPath.empty() && !loadDictionary(opt.dictPath)) return finishRun(opt, 1);
+
+    // shard workers only report their one line
+    if (opt.shardOut.empty()) cout << "Resume Filter - Console version\n";
+    string resumes_folder = opt.resumesFolder;
+    if (opt.loadSnapshotPath.empty() && resumes_folder.empty()) {
+        cout << "Enter path to folder containing resume .txt files: ";
+        getline(cin, resumes_folder);
+
+        if (resumes_folder.empty()) {
+            cout << "No folder provided. Exiting.\n";
+            return finishRun(opt, 1);
+        }
+    }
+
+    if (!opt.packPath.empty()) {
+        size_t packed = 0;
+        if (!packBundle(resumes_folder, opt.packPath, &packed)) return finishRun(opt, 1);
+        cout << "Packed " << packed << " resumes into: " << opt.packPath << "\n";
+        return finishRun(opt, 0);
+    }
+
+    if (!opt.serveSocket.empty()) {
+        ServerOptions server;
+        server.socketPath = opt.serveSocket;
+        server.resumesFolder = resumes_folder;
+        server.ingest.threads = opt.threads;
+        server.ingest.cachePath = opt.cachePath;
+        if (opt.top > 0) server.top = opt.top;
+        server.reloadSeconds = opt.reloadSeconds;
+        server.profileSet = opt.profileSet;
+        server.profile = opt.profile;
+        server.dedupe = opt.dedupe;
+        server.dedupeThreshold = opt.dedupeThreshold;
+        return finishRun(opt, runServer(server));
+    }
+
+    string job_file = opt.jobFile;
+    if (opt.batchJobsFolder.empty() && job_file.empty()) {
+        cout << "Enter path to job description file (.txt): ";
+        getline(cin, job_file);
+
+        if (job_file.empty()) {
+            cout << "No job description file provided. Exiting.\n";
+            return finishRun(opt, 1);
+        }
+    }
+
+    if (opt.watch) {
+        WatchOptions watch;
+        watch.resumesFolder = resumes_folder;
+        watch.jobFile = job_file;
+        watch.ingest.threads = opt.threads;
+        watch.ingest.cachePath = opt.cachePath;
+        watch.profileSet = opt.profileSet;
+        watch.profile = opt.profile;
+        return finishRun(opt, runWatch(watch));
+    }
+    if (opt.shards > 0) return finishRun(opt, runSharded(opt, resumes_folder, job_file));
+    if (opt.top > 0) return finishRun(opt, runTopK(opt, resumes_folder, job_file));
+
+    // 1) Read resumes (or a snapshot of an earlier parse). A plain run maps the
+    // snapshot's scoring pool as it is; dedupe, batch scoring and re-saving need the
+    // resume text, so they read its candidates instead.
+    CandidatePool pool;
+    vector<Candidate> candidates;
+    const bool mapPool = !opt.loadSnapshotPath.empty() && !opt.dedupe && opt.batchJobsFolder.empty()
+        && opt.saveSnapshotPath.empty();
+    if (mapPool) {
+        if (!loadPoolSnapshot(opt.loadSnapshotPath, pool)) return finishRun(opt, 1);
+        if (poolSize(pool) == 0) {
+            cout << "Snapshot holds no candidates: " << opt.loadSnapshotPath << "\n";
+            return finishRun(opt, 1);
+        }
+    }
+    else if (!opt.loadSnapshotPath.empty()) {
+        if (!loadSnapshot(opt.loadSnapshotPath, candidates)) return finishRun(opt, 1);
+        if (candidates.empty()) {
+            cout << "Snapshot holds no candidates: " << opt.loadSnapshotPath << "\n";
+            return finishRun(opt, 1);
+        }
+    }
+    else {
+        RF_TIMED_SCOPE("read resumes");
+        IngestOptions ingest;
+        ingest.threads = opt.threads;
+        ingest.cachePath = opt.cachePath;
+        IngestStats stats;
+        candidates = parseResumesFromFolder(resumes_folder, ingest, &stats);
+        if (!opt.cachePath.empty()) {
+            cout << "Cache: " << stats.cacheHits << " hit, " << stats.cacheMisses << " missed, "
+                << stats.cacheEvicted << " evicted\n";
+        }
+        if (candidates.empty()) {
+            cout << "No resumes found in folder: " << resumes_folder << "\n";
+            return finishRun(opt, 1);
+        }
+    }
+    if (!opt.saveSnapshotPath.empty() && savePoolSnapshot(opt.saveSnapshotPath, candidates)) {
+        cout << "Snapshot written to: " << opt.saveSnapshotPath << "\n";
+    }
+
+    // near-duplicates are scored once, through their cluster's representative
+    DedupeResult dedupe;
+    if (opt.dedupe) {
+        dedupe = findNearDuplicates(candidates, opt.threads, opt.dedupeThreshold);
+        cout << "Dedupe: " << dedupe.duplicates << " near-duplicate resumes in " << dedupe.clusters << " clusters\n";
+    }
+
+    if (!opt.batchJobsFolder.empty()) {
+        if (opt.dedupe) {
+            vector<Candidate> kept;
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                if (dedupe.representative[i] == i) kept.push_back(move(candidates[i]));
+            }
+            candidates = move(kept);
+        }
+        return finishRun(opt, runBatch(opt, candidates));
+    }
+
+    // columnar copy for scoring; the per-candidate buffers are freed as it is built
+    if (!mapPool) pool = poolFromCandidates(move(candidates), opt.dedupe ? &dedupe.representative : nullptr);
+
+    // 2) Read job description
+    Job job = loadJob(opt, job_file);
+
+    // 3) Score candidates and rank them, best first
+    scorePool(pool, job, opt.threads);
+    rankPool(pool, opt.threads);
+
+    // 4) Print results to console
+    printResults(pool);
+
+    // 5) Generate report (selected candidates)
+    string report_path = "selected_candidates_report.txt";
+    bool ok = writeReport(report_path, pool, job);
+    if (ok) {
+        cout << "\nReport written to: " << report_path << "\n";
+    }
+    else {
+        cout << "\nFailed to write report.\n";
+    }
+
+    cout << "Done.\n";
+    return finishRun(opt, 0);
 }
\ No newline at end of file
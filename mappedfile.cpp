@@ -0,0 +1,94 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::~MappedFile()
+{
+    unmapFile(*this);
+}
+
+#ifdef _WIN32
+
+bool mapFile(MappedFile& f, const string& path)
+{
+    unmapFile(f);
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    f.fileHandle = file;
+    f.size = (size_t)size.QuadPart;
+    if (f.size == 0) return true; // cannot map an empty file, but it is valid
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        unmapFile(f);
+        return false;
+    }
+    f.mappingHandle = mapping;
+    f.data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (f.data == nullptr) {
+        unmapFile(f);
+        return false;
+    }
+    return true;
+}
+
+void unmapFile(MappedFile& f)
+{
+    if (f.data) UnmapViewOfFile(f.data);
+    if (f.mappingHandle) CloseHandle((HANDLE)f.mappingHandle);
+    if (f.fileHandle) CloseHandle((HANDLE)f.fileHandle);
+    f.data = nullptr;
+    f.size = 0;
+    f.mappingHandle = nullptr;
+    f.fileHandle = nullptr;
+}
+
+#else
+
+bool mapFile(MappedFile& f, const string& path)
+{
+    unmapFile(f);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    f.fd = fd;
+    f.size = (size_t)st.st_size;
+    if (f.size == 0) return true; // cannot map an empty file, but it is valid
+    void* p = mmap(nullptr, f.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        unmapFile(f);
+        return false;
+    }
+    f.data = (const char*)p;
+    return true;
+}
+
+void unmapFile(MappedFile& f)
+{
+    if (f.data) munmap((void*)f.data, f.size);
+    if (f.fd >= 0) close(f.fd);
+    f.data = nullptr;
+    f.size = 0;
+    f.fd = -1;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+// Read-only memory mapping of a whole file (mmap on POSIX, a file mapping on Windows).
+// The mapping is released by unmapFile or when the struct goes out of scope.
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+};
+
+// false if the file cannot be opened or mapped; an empty file maps to size 0
+bool mapFile(MappedFile& f, const string& path);
+void unmapFile(MappedFile& f);
+
+#endif // MAPPEDFILE_H
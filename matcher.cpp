@@ -0,0 +1,134 @@
+#include "matcher.h"
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+using namespace std;
+
+static bool isWordChar(char ch)
+{
+    return isalnum((unsigned char)ch) != 0;
+}
+
+// "c++" and "c#" are one word each, not "c" followed by punctuation
+static bool endsWord(char last, char next)
+{
+    if (isWordChar(next)) return false;
+    return !(isalpha((unsigned char)last) && (next == '+' || next == '#'));
+}
+
+void buildMatcher(PatternMatcher& m, const vector<string>& patterns, bool longestOnly)
+{
+    m.longestOnly = longestOnly;
+    m.patterns.clear();
+    for (auto& p : patterns) {
+        string lp;
+        for (char ch : p) lp.push_back((char)tolower((unsigned char)ch));
+        m.patterns.push_back(lp);
+    }
+
+    // alphabet: one class per distinct byte used by the patterns, upper- and
+    // lowercase sharing a class; everything else falls into class 0
+    for (int b = 0; b < 256; ++b) m.classOf[b] = 0;
+    m.classes = 1;
+    for (auto& p : m.patterns) {
+        for (unsigned char ch : p) {
+            if (m.classOf[ch] != 0) continue;
+            if (m.classes == 256) continue; // cannot happen: at most 255 distinct bytes
+            m.classOf[ch] = (uint8_t)m.classes;
+            m.classOf[toupper(ch)] = (uint8_t)m.classes;
+            m.classes++;
+        }
+    }
+    const int A = m.classes;
+
+    // trie
+    m.next.assign(A, -1);
+    m.out.assign(1, -1);
+    m.samePattern.assign(m.patterns.size(), -1);
+    vector<int32_t> lastPattern(1, -1);
+    for (size_t i = 0; i < m.patterns.size(); ++i) {
+        if (m.patterns[i].empty()) continue;
+        int32_t s = 0;
+        for (unsigned char ch : m.patterns[i]) {
+            int c = m.classOf[ch];
+            if (m.next[s * A + c] < 0) {
+                m.next[s * A + c] = (int32_t)m.out.size();
+                m.next.resize(m.next.size() + A, -1);
+                m.out.push_back(-1);
+                lastPattern.push_back(-1);
+            }
+            s = m.next[s * A + c];
+        }
+        if (m.out[s] < 0) m.out[s] = (int32_t)i;
+        else m.samePattern[lastPattern[s]] = (int32_t)i;
+        lastPattern[s] = (int32_t)i;
+    }
+
+    // breadth-first: failure links turn the trie into a full DFA
+    size_t states = m.out.size();
+    vector<int32_t> fail(states, 0);
+    m.dictLink.assign(states, -1);
+    vector<int32_t> queue;
+    queue.reserve(states);
+    for (int c = 0; c < A; ++c) {
+        int32_t t = m.next[c];
+        if (t < 0) m.next[c] = 0;
+        else queue.push_back(t);
+    }
+    for (size_t qi = 0; qi < queue.size(); ++qi) {
+        int32_t s = queue[qi];
+        int32_t f = fail[s];
+        m.dictLink[s] = m.out[f] >= 0 ? f : m.dictLink[f];
+        for (int c = 0; c < A; ++c) {
+            int32_t t = m.next[s * A + c];
+            if (t < 0) {
+                m.next[s * A + c] = m.next[f * A + c];
+            }
+            else {
+                fail[t] = m.next[f * A + c];
+                queue.push_back(t);
+            }
+        }
+    }
+}
+
+void findPatterns(const PatternMatcher& m, string_view text, vector<uint8_t>& found)
+{
+    found.assign(m.patterns.size(), 0);
+    if (m.next.empty()) return;
+    // longestOnly: hits as (start, pattern), settled once the scan is over, since the
+    // longer of two hits at one start is the one that ends later
+    static thread_local vector<pair<size_t, int32_t>> hits;
+    hits.clear();
+    const int A = m.classes;
+    int32_t s = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        s = m.next[s * A + m.classOf[(unsigned char)text[i]]];
+        for (int32_t t = m.out[s] >= 0 ? s : m.dictLink[s]; t >= 0; t = m.dictLink[t]) {
+            for (int32_t p = m.out[t]; p >= 0; p = m.samePattern[p]) {
+                // like regex \b: only an edge that is itself a word character needs
+                // a non-word neighbour, so ".net" still matches inside "asp.net"
+                const string& pat = m.patterns[p];
+                size_t start = i + 1 - pat.size();
+                bool startOk = !isWordChar(pat.front()) || start == 0 || !isWordChar(text[start - 1]);
+                bool endOk = !isWordChar(pat.back()) || i + 1 == text.size() || endsWord(pat.back(), text[i + 1]);
+                if (!startOk || !endOk) continue;
+                if (m.longestOnly) hits.emplace_back(start, p);
+                else found[p] = 1;
+            }
+        }
+    }
+    if (hits.empty()) return;
+
+    sort(hits.begin(), hits.end(), [&](const pair<size_t, int32_t>& a, const pair<size_t, int32_t>& b) {
+        if (a.first != b.first) return a.first < b.first;
+        return m.patterns[a.second].size() > m.patterns[b.second].size();
+    });
+    size_t longest = 0;
+    for (size_t h = 0; h < hits.size(); ++h) {
+        const size_t length = m.patterns[hits[h].second].size();
+        if (h == 0 || hits[h].first != hits[h - 1].first) longest = length;
+        if (length == longest) found[hits[h].second] = 1;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef MATCHER_H
+#define MATCHER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Case-insensitive multi-pattern matcher (Aho-Corasick compiled to a DFA). One pass
+// over the text finds every pattern, however many there are. A hit only counts at word
+// boundaries (like regex \b around the pattern), so "ml" does not fire inside "html";
+// a letter followed by '+' or '#' does not end a word, so "c" does not fire inside
+// "c++" or "c#". With longestOnly, of the hits starting at one position only the
+// longest counts, so a pattern that is a prefix of another is not reported with it.
+struct PatternMatcher {
+    vector<string> patterns;        // lowercased, in the order they were given
+    uint8_t classOf[256] = {};      // byte -> alphabet class (0 = not in any pattern)
+    int classes = 1;
+    vector<int32_t> next;           // state * classes + class -> state
+    vector<int32_t> out;            // first pattern ending at this state, or -1
+    vector<int32_t> dictLink;       // nearest suffix state with an output, or -1
+    vector<int32_t> samePattern;    // next pattern with identical text, or -1
+    bool longestOnly = false;
+};
+
+void buildMatcher(PatternMatcher& m, const vector<string>& patterns, bool longestOnly = false);
+
+// sets found[i] = 1 for every pattern i that occurs in text; found is resized to
+// the pattern count and cleared first
+void findPatterns(const PatternMatcher& m, string_view text, vector<uint8_t>& found);
+
+#endif // MATCHER_H
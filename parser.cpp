@@ -1,281 +1,796 @@
-﻿#include "parser.h"
-#include "utils.h"
-
-#include <filesystem>
-#include <fstream>
-#include <sstream>
-#include <regex>
-#include <iostream>
-
-using namespace std;
-namespace fs = std::filesystem;
-
-// Helper to lowercase & trim a copy of a string
-static string lowerTrim(const string& s) {
-    return toLower(trim(s));
-}
-
-// split a "key: value" line into key and value (both trimmed)
-static pair<string, string> splitKeyValue(const string& line) {
-    size_t pos = line.find(':');
-    if (pos == string::npos) return { trim(line), "" };
-    string key = trim(line.substr(0, pos));
-    string val = trim(line.substr(pos + 1));
-    return { key, val };
-}
-
-// Try to parse a number (integer or decimal) from a string. Returns true if found.
-static bool parseFirstNumber(const string& s, double& out) {
-    // simple regex to find first floating number like 3.7 or 9.0/10 or 3
-    try {
-        std::smatch m;
-        std::regex fracR("([0-9]+\\.?[0-9]*)\\s*\\/\\s*([0-9]+\\.?[0-9]*)");
-        if (std::regex_search(s, m, fracR)) {
-            double a = stod(m[1].str());
-            double b = stod(m[2].str());
-            if (b > 0.0) {
-                // normalize to 4.0 if denominator > 4
-                if (b > 4.0) out = (a / b) * 4.0;
-                else out = a;
-                return true;
-            }
-        }
-        // simple decimal/integer
-        std::regex numR("([0-9]+\\.?[0-9]*)");
-        if (std::regex_search(s, m, numR)) {
-            out = stod(m[1].str());
-            return true;
-        }
-    }
-    catch (...) {
-        return false;
-    }
-    return false;
-}
-
-// parse a single resume file into Candidate
-static Candidate parseSingleResume(const string& path)
-{
-    Candidate c;
-    c.filepath = path;
-
-    ifstream in(path);
-    if (!in.is_open()) {
-        cout << "Warning: cannot open " << path << "\n";
-        return c;
-    }
-
-    vector<string> lines;
-    string line;
-    string fullText;
-    while (getline(in, line)) {
-        lines.push_back(line);
-        fullText += line + "\n";
-    }
-    in.close();
-
-    // 1) Name: find a line starting "Name:" or fallback to first non-empty line
-    bool nameFound = false;
-    for (auto& ln : lines) {
-        auto kv = splitKeyValue(ln);
-        string keyLower = lowerTrim(kv.first);
-        if (keyLower == "name" && !kv.second.empty()) {
-            c.name = kv.second;
-            nameFound = true;
-            break;
-        }
-    }
-    if (!nameFound) {
-        // fallback: first non-empty line
-        for (auto& ln : lines) {
-            string t = trim(ln);
-            if (!t.empty()) {
-                c.name = t;
-                break;
-            }
-        }
-    }
-
-    // 2) GPA: look for lines that mention "gpa", "cgpa", or "grade" and parse numbers
-    bool gpaFound = false;
-    for (auto& ln : lines) {
-        string lower = lowerTrim(ln);
-        if (lower.find("gpa") != string::npos || lower.find("cgpa") != string::npos || lower.find("grade") != string::npos) {
-            double val = 0.0;
-            if (parseFirstNumber(ln, val)) {
-                c.gpa = val;
-                gpaFound = true;
-                break;
-            }
-        }
-    }
-    // if not found, try to find fraction anywhere e.g. "9.0/10" in full text
-    if (!gpaFound) {
-        double val = 0.0;
-        if (parseFirstNumber(fullText, val)) {
-            // only accept as GPA if value looks reasonable (>= 2.0 or <= 10.0)
-            if (val > 0.0 && val <= 10.0) c.gpa = val;
-        }
-    }
-
-    // 3) Skills: look for "skills" or "technical skills" lines, parse after colon
-    bool skillsFound = false;
-    for (auto& ln : lines) {
-        string lower = lowerTrim(ln);
-        if (lower.rfind("skills", 0) == 0 || lower.rfind("technical skills", 0) == 0 || lower.find("technical skills") != string::npos) {
-            auto kv = splitKeyValue(ln);
-            string val = kv.second;
-            if (val.empty()) {
-                // maybe skills span the rest of file - ignore complexity for now
-                continue;
-            }
-            vector<string> list = splitByMultiple(val, ",;|");
-            for (auto& s : list) {
-                string sk = normalizeSkill(s);
-                if (!sk.empty()) c.skills.push_back(sk);
-            }
-            skillsFound = true;
-            break;
-        }
-    }
-    // fallback: scan full text for known skill tokens
-    if (!skillsFound) {
-        string lowerFull = toLower(fullText);
-        vector<string> known = { "c++","cpp","java","python","sql","javascript","html","css","git","linux","algorithms","data structures","machine learning","ml" };
-        for (auto& k : known) {
-            if (containsToken(lowerFull, k)) {
-                string nk = normalizeSkill(k);
-                bool exists = false;
-                for (auto& ex : c.skills) if (toLower(ex) == nk) { exists = true; break; }
-                if (!exists) c.skills.push_back(nk);
-            }
-        }
-    }
-
-    // 4) Experience: look for "years" and sum numbers found on lines mentioning "year" or "experience"
-    int totalYears = 0;
-    for (auto& ln : lines) {
-        string lower = lowerTrim(ln);
-        if (lower.find("year") != string::npos || lower.find("experience") != string::npos) {
-            std::smatch m;
-            std::regex numR("([0-9]+)");
-            auto begin = std::sregex_iterator(ln.begin(), ln.end(), numR);
-            auto end = std::sregex_iterator();
-            for (auto it = begin; it != end; ++it) {
-                try {
-                    totalYears += stoi((*it)[1].str());
-                }
-                catch (...) {}
-            }
-        }
-    }
-    if (totalYears > 0) c.experienceYears = totalYears;
-
-    // 5) Certifications: look for lines starting with "cert" and parse list
-    for (auto& ln : lines) {
-        string lower = lowerTrim(ln);
-        if (lower.rfind("certifications", 0) == 0 || lower.rfind("certificates", 0) == 0 || lower.find("certificate") != string::npos) {
-            auto kv = splitKeyValue(ln);
-            string val = kv.second;
-            if (!val.empty()) {
-                vector<string> list = splitByMultiple(val, ",;|");
-                for (auto& s : list) {
-                    string cc = trim(s);
-                    if (!cc.empty()) c.certifications.push_back(cc);
-                }
-            }
-        }
-    }
-    // fallback: look for known cert tokens inside full text
-    {
-        string lowerFull = toLower(fullText);
-        vector<string> knownCerts = { "aws certified solutions architect", "aws", "azure", "ccna", "oracle", "pmp", "ocjp" };
-        for (auto& k : knownCerts) {
-            if (containsToken(lowerFull, k)) {
-                bool exists = false;
-                for (auto& ex : c.certifications) {
-                    if (toLower(ex).find(toLower(k)) != string::npos) { exists = true; break; }
-                }
-                if (!exists) c.certifications.push_back(k);
-            }
-        }
-    }
-
-    return c;
-}
-
-vector<Candidate> parseResumesFromFolder(const string& folderPath)
-{
-    vector<Candidate> result;
-    try {
-        for (auto& ent : fs::directory_iterator(folderPath)) {
-            if (!ent.is_regular_file()) continue;
-            string path = ent.path().string();
-            if (ent.path().extension() == ".txt") {
-                Candidate c = parseSingleResume(path);
-                result.push_back(c);
-            }
-        }
-    }
-    catch (const std::exception& e) {
-        cout << "Error reading folder: " << e.what() << "\n";
-    }
-    return result;
-}
-
-Job parseJobDescription(const string& jobFilePath)
-{
-    Job job;
-    ifstream in(jobFilePath);
-    if (!in.is_open()) {
-        cout << "Cannot open job description file: " << jobFilePath << "\n";
-        return job;
-    }
-    string line;
-    vector<string> lines;
-    string content;
-    while (getline(in, line)) {
-        lines.push_back(line);
-        content += line + "\n";
-    }
-    in.close();
-
-    // parse line-by-line for specific keys
-    for (auto& ln : lines) {
-        auto kv = splitKeyValue(ln);
-        string key = lowerTrim(kv.first);
-        string val = kv.second;
-        if (key.find("required skills") != string::npos || key == "required skills" || key == "required skill") {
-            vector<string> list = splitByMultiple(val, ",;|");
-            for (auto& s : list) if (!trim(s).empty()) job.requiredSkills.push_back(normalizeSkill(s));
-        }
-        else if (key.find("preferred skills") != string::npos || key == "preferred skills" || key == "preferred skill") {
-            vector<string> list = splitByMultiple(val, ",;|");
-            for (auto& s : list) if (!trim(s).empty()) job.preferredSkills.push_back(normalizeSkill(s));
-        }
-        else if (key.find("min gpa") != string::npos || key == "min gpa" || key == "min gpa:") {
-            double v = 0.0;
-            if (parseFirstNumber(val, v)) job.minGPA = v;
-        }
-        else if (key.find("min experience") != string::npos || key == "min experience") {
-            double v = 0.0;
-            if (parseFirstNumber(val, v)) job.minExperience = (int)v;
-        }
-        else if (key.find("required certifications") != string::npos || key.find("required certification") != string::npos) {
-            vector<string> list = splitByMultiple(val, ",;|");
-            for (auto& s : list) if (!trim(s).empty()) job.requiredCerts.push_back(trim(s));
-        }
-    }
-
-    // fallback keywords: extract words of length >= 4 from top of content
-    {
-        string prefix = content.substr(0, min((size_t)1000, content.size()));
-        vector<string> tokens = splitByMultiple(prefix, " ,.;:\n");
-        for (auto& t : tokens) {
-            string tt = trim(t);
-            if (tt.size() >= 4) job.keywords.push_back(toLower(tt));
-        }
-    }
-
-    return job;
+﻿#include "parser.h"
+#include "utils.h"
+#include "threadpool.h"
+#include "matcher.h"
+#include "snapshot.h"
+#include "stats.h"
+#include "allocstats.h"
+#include "skillalias.h"
+#include "fileloader.h"
+#include "bundle.h"
+#include "mappedfile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <mutex>
+#include <charconv>
+#include <string_view>
+#include <cctype>
+#include <unordered_map>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// resumes are parsed on several threads; keep their console messages from interleaving
+static mutex logMutex;
+
+static void logLine(const string& msg)
+{
+    lock_guard<mutex> lock(logMutex);
+    cout << msg << "\n";
+}
+
+// split a "key: value" line into key and value (both trimmed); no colon means the
+// whole line is the key
+static void splitKeyValue(string_view line, string_view& key, string_view& val) {
+    size_t colon = line.find(':');
+    if (colon == string_view::npos) {
+        key = trimView(line);
+        val = string_view();
+        return;
+    }
+    key = trimView(line.substr(0, colon));
+    val = trimView(line.substr(colon + 1));
+}
+
+// Hand-written replacements for the old std::regex patterns. They accept the same
+// text: a decimal is [0-9]+\.?[0-9]* and whitespace is whatever isspace() accepts.
+static bool isDigit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+// end of the decimal that starts at s[i] (s[i] must be a digit)
+static size_t scanDecimal(string_view s, size_t i) {
+    while (i < s.size() && isDigit(s[i])) i++;
+    if (i < s.size() && s[i] == '.') i++;
+    while (i < s.size() && isDigit(s[i])) i++;
+    return i;
+}
+
+static size_t skipSpace(string_view s, size_t i) {
+    while (i < s.size() && isspace((unsigned char)s[i])) i++;
+    return i;
+}
+
+// false on overflow, like the std::stod call this replaces
+static bool toDouble(string_view digits, double& out) {
+    auto r = from_chars(digits.data(), digits.data() + digits.size(), out);
+    return r.ec == errc();
+}
+
+bool parseFirstNumber(string_view s, double& out) {
+    RF_STAT_ADD(STAT_NUMBER_SCANS, 1);
+    // first fraction "a / b"; starting inside a digit run can never succeed where
+    // starting at the run's first digit failed, so only run starts are tried
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (!isDigit(s[i]) || (i > 0 && isDigit(s[i - 1]))) continue;
+        size_t aEnd = scanDecimal(s, i);
+        size_t j = skipSpace(s, aEnd);
+        if (j >= s.size() || s[j] != '/') continue;
+        j = skipSpace(s, j + 1);
+        if (j >= s.size() || !isDigit(s[j])) continue;
+        size_t bEnd = scanDecimal(s, j);
+        double a = 0.0, b = 0.0;
+        if (!toDouble(s.substr(i, aEnd - i), a) || !toDouble(s.substr(j, bEnd - j), b)) return false;
+        if (b > 0.0) {
+            // normalize to 4.0 if denominator > 4
+            if (b > 4.0) out = (a / b) * 4.0;
+            else out = a;
+            return true;
+        }
+        break; // only the first fraction counts; fall back to a plain number
+    }
+    // simple decimal/integer
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (!isDigit(s[i])) continue;
+        return toDouble(s.substr(i, scanDecimal(s, i) - i), out);
+    }
+    return false;
+}
+
+// sum of every run of digits in the line; runs too large for an int are skipped
+static int sumIntegers(string_view s) {
+    int total = 0;
+    size_t i = 0;
+    while (i < s.size()) {
+        if (!isDigit(s[i])) { i++; continue; }
+        size_t end = i;
+        while (end < s.size() && isDigit(s[end])) end++;
+        int v = 0;
+        auto r = from_chars(s.data() + i, s.data() + end, v);
+        if (r.ec == errc()) total += v;
+        i = end;
+    }
+    return total;
+}
+
+static bool startsWith(string_view s, string_view prefix) {
+    return s.substr(0, prefix.size()) == prefix;
+}
+
+static bool contains(string_view s, string_view needle) {
+    return s.find(needle) != string_view::npos;
+}
+
+static TextSpan makeSpan(size_t offset, size_t length) {
+    TextSpan s;
+    s.offset = (uint32_t)offset;
+    s.length = (uint32_t)length;
+    return s;
+}
+
+// span of a view that points into `base`
+static TextSpan spanOf(string_view base, string_view part) {
+    return makeSpan((size_t)(part.data() - base.data()), part.size());
+}
+
+// Known skill and certification names for the full-text fallbacks, each list compiled
+// into one matcher. Built-in lists unless loadDictionary() replaced them.
+struct KnownNames {
+    vector<string> skills;
+    vector<string> certs;
+    PatternMatcher skillMatcher;
+    PatternMatcher certMatcher;
+};
+
+static KnownNames makeKnownNames(vector<string> skills, vector<string> certs)
+{
+    KnownNames k;
+    k.skills = move(skills);
+    k.certs = move(certs);
+    // skills in free text: "c++" is one skill, not also "c"
+    buildMatcher(k.skillMatcher, k.skills, true);
+    buildMatcher(k.certMatcher, k.certs);
+    return k;
+}
+
+static KnownNames& knownNames()
+{
+    static KnownNames k = makeKnownNames(
+        { "c++","cpp","java","python","sql","javascript","html","css","git","linux","algorithms","data structures","machine learning","ml" },
+        { "aws certified solutions architect", "aws", "azure", "ccna", "oracle", "pmp", "ocjp" });
+    return k;
+}
+
+bool loadDictionary(const string& path)
+{
+    ifstream in(path);
+    if (!in.is_open()) {
+        cout << "Cannot open dictionary file: " << path << "\n";
+        return false;
+    }
+    vector<string> skills, certs;
+    vector<pair<string, string>> aliases;
+    vector<string>* section = &skills; // entries before any header are skills
+    bool sawSkills = false, sawCerts = false, sawAliases = false;
+    string line;
+    while (getline(in, line)) {
+        string t = trim(line);
+        if (t.empty() || t[0] == '#') continue;
+        string lower = toLower(t);
+        if (lower == "[skills]") { section = &skills; sawSkills = true; continue; }
+        if (lower == "[certifications]") { section = &certs; sawCerts = true; continue; }
+        if (lower == "[aliases]") { section = nullptr; sawAliases = true; continue; }
+        if (t[0] == '[') {
+            cout << "Unknown dictionary section " << t << " in " << path << "\n";
+            return false;
+        }
+        if (section == nullptr) {
+            // "alias = canonical", both normalized like any skill name
+            size_t eq = t.find('=');
+            if (eq == string::npos) {
+                cout << "Expected \"alias = skill\" in " << path << ": " << t << "\n";
+                return false;
+            }
+            aliases.emplace_back(toLower(trim(t.substr(0, eq))), toLower(trim(t.substr(eq + 1))));
+            continue;
+        }
+        if (section == &skills) sawSkills = true;
+        section->push_back(t);
+    }
+    AliasTable aliasTable;
+    if (sawAliases && !buildAliasTable(aliasTable, aliases)) return false;
+
+    // a file may provide just some of the lists; the others keep their current contents
+    KnownNames& k = knownNames();
+    k = makeKnownNames(sawSkills ? skills : k.skills, sawCerts ? certs : k.certs);
+    if (sawAliases) setSkillAliases(move(aliasTable));
+    return true;
+}
+
+// candidate with no parsed fields, only its source path
+static Candidate emptyCandidate(const string& path)
+{
+    Candidate c;
+    c.text = path;
+    c.filepath = makeSpan(0, path.size());
+    return c;
+}
+
+// Extract every Candidate field from c.text (the raw resume) in one pass over its
+// lines. Each field keeps its own "first match wins" / "accumulate" rule, so the result
+// is the same as scanning the lines once per field; only the fallbacks (GPA anywhere,
+// known skill and cert names) look at the whole text again. Name and certification
+// spans point straight into the resume bytes; cert names that do not occur verbatim
+// are appended to c.text once the scan is over. Skills are interned as they are found.
+static void parseResumeText(Candidate& c, const string& path)
+{
+    RF_TIMED_SCOPE("parse resume");
+    RF_ALLOC_RESUME();
+    const string_view text = c.text;
+
+    bool nameFound = false;
+    string_view firstNonEmpty;
+    bool gpaFound = false;
+    bool skillsFound = false;
+    int totalYears = 0;
+    // per-thread buffers, so a warmed-up worker parses without allocating beyond the
+    // candidate's own vectors
+    static thread_local string lower;   // lowercase copy of the current trimmed line
+    static thread_local string scratch; // normalized skill name on its way to the interner
+
+    auto addSkill = [&](string_view raw) {
+        scratch.clear();
+        appendNormalizedSkill(scratch, raw);
+        uint32_t id = internSkill(scratch);
+        for (uint32_t ex : c.skills) if (ex == id) return;
+        c.skills.push_back(id);
+    };
+
+    string_view rest = text;
+    string_view ln;
+    while (nextLine(rest, ln)) {
+        string_view trimmed = trimView(ln);
+        lower.clear();
+        appendLower(lower, trimmed);
+
+        string_view key, val;
+        splitKeyValue(ln, key, val);
+
+        // 1) Name: a "Name:" line, or else the first non-empty line
+        if (!nameFound && !val.empty() && equalsNoCase(key, "name")) {
+            c.name = spanOf(text, val);
+            nameFound = true;
+        }
+        if (firstNonEmpty.empty() && !trimmed.empty()) firstNonEmpty = trimmed;
+
+        // 2) GPA: first line mentioning "gpa", "cgpa" or "grade" that holds a number
+        if (!gpaFound && (contains(lower, "gpa") || contains(lower, "grade"))) {
+            double val2 = 0.0;
+            if (parseFirstNumber(ln, val2)) {
+                c.gpa = val2;
+                gpaFound = true;
+            }
+        }
+
+        // 3) Skills: first "skills" / "technical skills" line with a value after the colon
+        if (!skillsFound && !val.empty() && (startsWith(lower, "skills") || contains(lower, "technical skills"))) {
+            forEachListItem(val, ",;|", addSkill);
+            skillsFound = true;
+        }
+
+        // 4) Experience: sum the numbers on every line mentioning "year" or "experience"
+        if (contains(lower, "year") || contains(lower, "experience")) {
+            totalYears += sumIntegers(ln);
+        }
+
+        // 5) Certifications: every "certifications" / "certificates" line
+        if (!val.empty() && (startsWith(lower, "certifications") || startsWith(lower, "certificates") || contains(lower, "certificate"))) {
+            forEachListItem(val, ",;|", [&](string_view item) {
+                c.certifications.push_back(spanOf(text, item));
+            });
+        }
+    }
+
+    if (!nameFound && !firstNonEmpty.empty()) c.name = spanOf(text, firstNonEmpty);
+
+    // if not found, try to find fraction anywhere e.g. "9.0/10" in full text
+    if (!gpaFound) {
+        double val = 0.0;
+        if (parseFirstNumber(text, val)) {
+            // only accept as GPA if value looks reasonable (>= 2.0 or <= 10.0)
+            if (val > 0.0 && val <= 10.0) c.gpa = val;
+        }
+    }
+
+    // fallbacks: one pass of the compiled dictionaries over the full text
+    const KnownNames& known = knownNames();
+    static thread_local vector<uint8_t> found;
+
+    // known skill tokens, added in dictionary order
+    if (!skillsFound) {
+        findPatterns(known.skillMatcher, text, found);
+        for (size_t i = 0; i < found.size(); ++i) {
+            if (found[i]) addSkill(known.skills[i]);
+        }
+    }
+
+    if (totalYears > 0) c.experienceYears = totalYears;
+
+    // known cert tokens, unless a listed certification already mentions them
+    vector<string_view> extraCerts;
+    findPatterns(known.certMatcher, text, found);
+    for (size_t i = 0; i < found.size(); ++i) {
+        if (!found[i]) continue;
+        string_view k = known.certs[i];
+        bool exists = false;
+        for (auto& ex : c.certifications) {
+            if (containsToken(text.substr(ex.offset, ex.length), k)) { exists = true; break; }
+        }
+        for (auto ex : extraCerts) {
+            if (containsToken(ex, k)) { exists = true; break; }
+        }
+        if (!exists) extraCerts.push_back(k);
+    }
+
+    // done reading the resume bytes: append the derived strings and the path
+    for (auto k : extraCerts) {
+        c.certifications.push_back(makeSpan(c.text.size(), k.size()));
+        c.text += k;
+    }
+    c.filepath = makeSpan(c.text.size(), path.size());
+    c.text += path;
+}
+
+// room past the file for the derived cert names and the path parseResumeText
+// appends, so each buffer is allocated once
+static const size_t PARSE_SPARE = 128;
+
+// false (after a warning) if the load failed
+static bool checkLoad(const string& path, FileLoadError error)
+{
+    switch (error) {
+    case LOAD_OK: return true;
+    case LOAD_CANNOT_OPEN: logLine("Warning: cannot open " + path); break;
+    case LOAD_TOO_LARGE: logLine("Warning: skipping oversized file " + path); break;
+    case LOAD_READ_FAILED: logLine("Warning: cannot read " + path); break;
+    }
+    return false;
+}
+
+// read the whole file into out; false (after a warning) if it cannot be opened or
+// is too large for the 32-bit spans
+static bool readResumeFile(const string& path, string& out)
+{
+    FileLoadError error;
+    loadFiles(&path, 1, PARSE_SPARE, &out, &error);
+    return checkLoad(path, error);
+}
+
+// Files per loadFiles batch: enough for the batched loader to pay off, small enough
+// that work stealing still evens out the threads at the end.
+static size_t loadBlockSize(size_t files, int threads)
+{
+    const size_t perThread = files / (size_t)max(threads, 1);
+    return max<size_t>(1, min<size_t>(32, perThread / 4));
+}
+
+// Identifies what a cached parse result depends on besides the file itself: bump
+// PARSER_REVISION whenever extraction rules change; the dictionary is hashed in.
+static const uint64_t PARSER_REVISION = 2;
+
+static uint64_t parserTag()
+{
+    const KnownNames& k = knownNames();
+    string all = to_string(PARSER_REVISION) + "\n[skills]\n";
+    for (auto& s : k.skills) all += s + "\n";
+    all += "[certifications]\n";
+    for (auto& s : k.certs) all += s + "\n";
+    all += "[aliases]\n";
+    const AliasTable& aliases = skillAliases();
+    for (auto& a : aliases.slots) {
+        all.append(aliases.text, a.keyOffset, a.keyLength);
+        all += '=';
+        all.append(aliases.text, a.valueOffset, a.valueLength);
+        all += '\n';
+    }
+    return hashBytes(all);
+}
+
+// every .txt file directly inside the folder, in directory order, with size and mtime
+static void listResumeFiles(const string& folderPath, vector<string>& paths, vector<FileStamp>& stamps)
+{
+    RF_TIMED_SCOPE("list folder");
+    try {
+        for (auto& ent : fs::directory_iterator(folderPath)) {
+            if (!ent.is_regular_file()) continue;
+            if (ent.path().extension() != ".txt") continue;
+            FileStamp st;
+            error_code ec;
+            st.size = (uint64_t)ent.file_size(ec);
+            st.mtime = (int64_t)ent.last_write_time(ec).time_since_epoch().count();
+            paths.push_back(ent.path().string());
+            stamps.push_back(st);
+        }
+    }
+    catch (const std::exception& e) {
+        cout << "Error reading folder: " << e.what() << "\n";
+    }
+}
+
+// A bundle is given where a folder would be: anything that is a file, not a folder.
+static bool isBundle(const string& sourcePath)
+{
+    error_code ec;
+    return fs::is_regular_file(sourcePath, ec);
+}
+
+// The resumes to parse: the .txt files of a folder, or the .txt entries of a bundle,
+// which are read straight out of the mapped archive. A bundle entry's path is its
+// name inside the archive.
+struct ResumeSource {
+    vector<string> paths;
+    vector<FileStamp> stamps;
+    MappedFile bundle;
+    vector<uint64_t> offsets;   // bundle only: where each file's bytes start
+};
+
+static void listResumes(const string& sourcePath, ResumeSource& src)
+{
+    if (!isBundle(sourcePath)) {
+        listResumeFiles(sourcePath, src.paths, src.stamps);
+        return;
+    }
+    if (!mapFile(src.bundle, sourcePath)) {
+        cout << "Cannot open bundle: " << sourcePath << "\n";
+        return;
+    }
+    vector<BundleEntry> entries;
+    listBundle(src.bundle.data, src.bundle.size, sourcePath, entries);
+    for (auto& e : entries) {
+        if (fs::path(e.name).extension() != ".txt") continue;
+        FileStamp st;
+        st.size = e.size;
+        st.mtime = e.mtime;
+        src.paths.push_back(move(e.name));
+        src.stamps.push_back(st);
+        src.offsets.push_back(e.offset);
+    }
+}
+
+// Loads src's files number slots[0..count) into data; the bundle's are copied out of
+// the mapping, which is also where the parser would have them if they were files.
+static void loadResumes(const ResumeSource& src, const size_t* slots, size_t count, string* data, FileLoadError* error)
+{
+    if (src.offsets.empty()) {
+        static thread_local vector<string> paths;
+        paths.clear();
+        for (size_t k = 0; k < count; ++k) paths.push_back(src.paths[slots[k]]);
+        loadFiles(paths.data(), count, PARSE_SPARE, data, error);
+        return;
+    }
+    RF_TIMED_SCOPE("read bundle");
+    for (size_t k = 0; k < count; ++k) {
+        const size_t i = slots[k];
+        const uint64_t size = src.stamps[i].size;
+        if (size > MAX_LOAD_SIZE) {
+            error[k] = LOAD_TOO_LARGE;
+            continue;
+        }
+        data[k].clear();
+        data[k].reserve((size_t)size + src.paths[i].size() + PARSE_SPARE);
+        data[k].assign(src.bundle.data + src.offsets[i], (size_t)size);
+        error[k] = LOAD_OK;
+        RF_STAT_ADD(STAT_BYTES_READ, size);
+    }
+}
+
+uint32_t shardOfFile(const string& path, uint32_t shardCount)
+{
+    if (shardCount <= 1) return 0;
+    return (uint32_t)(hashBytes(fs::path(path).filename().string()) % shardCount);
+}
+
+// drops the files that belong to other shards
+static void keepShard(const IngestOptions& options, ResumeSource& src)
+{
+    if (options.shardCount <= 1) return;
+    const bool bundle = !src.offsets.empty();
+    size_t kept = 0;
+    for (size_t i = 0; i < src.paths.size(); ++i) {
+        if (shardOfFile(src.paths[i], options.shardCount) != options.shard) continue;
+        if (kept != i) {
+            src.paths[kept] = move(src.paths[i]);
+            src.stamps[kept] = src.stamps[i];
+            if (bundle) src.offsets[kept] = src.offsets[i];
+        }
+        kept++;
+    }
+    src.paths.resize(kept);
+    src.stamps.resize(kept);
+    if (bundle) src.offsets.resize(kept);
+}
+
+Candidate parseResumeFile(const string& path, bool* failed)
+{
+    RF_ALLOC_STAGE(ALLOC_PARSE);
+    try {
+        Candidate c;
+        if (!readResumeFile(path, c.text)) {
+            if (failed) *failed = true;
+            return emptyCandidate(path);
+        }
+        parseResumeText(c, path);
+        return c;
+    }
+    catch (const std::exception& e) {
+        logLine("Warning: failed to parse " + path + ": " + e.what());
+        if (failed) *failed = true;
+        return emptyCandidate(path);
+    }
+}
+
+vector<Candidate> parseResumesFromFolder(const string& folderPath, const IngestOptions& options, IngestStats* stats,
+                                         vector<FileStamp>* stampsOut)
+{
+    RF_ALLOC_STAGE(ALLOC_PARSE);
+    // walk the folder first so every file gets a fixed slot: the result keeps
+    // directory order no matter which worker finishes first
+    ResumeSource src;
+    listResumes(folderPath, src);
+    keepShard(options, src);
+    const vector<string>& paths = src.paths;
+    vector<FileStamp>& stamps = src.stamps;
+
+    // previous results from the cache, matched to this walk by path; a bundle can hold
+    // a name more than once (`tar rf` appends a newer copy), so the n-th copy of a
+    // name is matched with the n-th cached entry of that name, and each cached entry
+    // goes to one slot at most
+    vector<Candidate> cached;
+    vector<FileStamp> cachedStamps;
+    vector<long long> cacheSlot(paths.size(), -1);
+    size_t cacheMatched = 0;
+    const uint64_t tag = parserTag();
+    if (!options.cachePath.empty() && fs::exists(options.cachePath)) {
+        uint64_t cachedTag = 0;
+        if (loadSnapshot(options.cachePath, cached, &cachedStamps, &cachedTag)
+            && cachedTag == tag && cachedStamps.size() == cached.size()) {
+            unordered_map<string_view, vector<size_t>> byPath;
+            for (size_t k = 0; k < cached.size(); ++k) byPath[spanText(cached[k], cached[k].filepath)].push_back(k);
+            unordered_map<string_view, size_t> copiesSeen;
+            for (size_t i = 0; i < paths.size(); ++i) {
+                auto it = byPath.find(paths[i]);
+                if (it == byPath.end()) continue;
+                const size_t copy = copiesSeen[paths[i]]++;
+                if (copy >= it->second.size()) continue;
+                cacheSlot[i] = (long long)it->second[copy];
+                cacheMatched++;
+            }
+        }
+        else {
+            cout << "Ingest cache is stale or unreadable, rebuilding: " << options.cachePath << "\n";
+            cached.clear();
+            cachedStamps.clear();
+        }
+    }
+
+    vector<Candidate> result(paths.size());
+    vector<uint8_t> hit(paths.size(), 0);
+    vector<uint8_t> failed(paths.size(), 0);
+    // files are loaded a block at a time and each buffer goes straight to the parser
+    const size_t block = loadBlockSize(paths.size(), options.threads);
+    parallelFor((paths.size() + block - 1) / block, options.threads, [&](size_t b, int) {
+        RF_ALLOC_STAGE(ALLOC_PARSE);
+        static thread_local vector<size_t> slots;
+        static thread_local vector<string> loaded;
+        static thread_local vector<FileLoadError> errors;
+        slots.clear();
+        for (size_t i = b * block; i < min(paths.size(), (b + 1) * block); ++i) {
+            const long long slot = cacheSlot[i];
+            // unchanged size and mtime: trust the cached result without opening the file
+            if (slot >= 0 && cachedStamps[slot].size == stamps[i].size && cachedStamps[slot].mtime == stamps[i].mtime) {
+                result[i] = move(cached[slot]);
+                stamps[i].hash = cachedStamps[slot].hash;
+                hit[i] = 1;
+                continue;
+            }
+            slots.push_back(i);
+        }
+        loaded.resize(slots.size());
+        errors.resize(slots.size());
+        loadResumes(src, slots.data(), slots.size(), loaded.data(), errors.data());
+
+        for (size_t k = 0; k < slots.size(); ++k) {
+            const size_t i = slots[k];
+            const long long slot = cacheSlot[i];
+            // a bad file only costs its own slot; the other workers keep going
+            try {
+                if (!checkLoad(paths[i], errors[k])) {
+                    result[i] = emptyCandidate(paths[i]);
+                    failed[i] = 1;
+                    continue;
+                }
+                Candidate c;
+                c.text = move(loaded[k]);
+                stamps[i].size = c.text.size();
+                stamps[i].hash = hashBytes(c.text);
+                // touched but not changed: still a hit
+                if (slot >= 0 && cachedStamps[slot].hash == stamps[i].hash) {
+                    result[i] = move(cached[slot]);
+                    hit[i] = 1;
+                    continue;
+                }
+                parseResumeText(c, paths[i]);
+                result[i] = move(c);
+            }
+            catch (const std::exception& e) {
+                logLine("Warning: failed to parse " + paths[i] + ": " + e.what());
+                result[i] = emptyCandidate(paths[i]);
+                failed[i] = 1;
+            }
+        }
+    });
+
+    // cached entries keep the index of their slot in this walk
+    for (size_t i = 0; i < result.size(); ++i) result[i].inputIndex = (uint32_t)i;
+
+    IngestStats st;
+    for (size_t i = 0; i < paths.size(); ++i) st.cacheHits += hit[i];
+    st.cacheMisses = paths.size() - st.cacheHits;
+    st.cacheEvicted = cached.size() - cacheMatched;
+
+    if (!options.cachePath.empty()) {
+        // files that could not be read are left out so the next run retries them
+        size_t failures = 0;
+        for (auto f : failed) failures += f;
+        if (failures == 0) {
+            saveSnapshot(options.cachePath, result, &stamps, tag);
+        }
+        else {
+            vector<Candidate> keep;
+            vector<FileStamp> keepStamps;
+            for (size_t i = 0; i < result.size(); ++i) {
+                if (failed[i]) continue;
+                keep.push_back(result[i]);
+                keepStamps.push_back(stamps[i]);
+            }
+            saveSnapshot(options.cachePath, keep, &keepStamps, tag);
+        }
+    }
+
+    if (stats) *stats = st;
+    if (stampsOut) *stampsOut = move(stamps);
+    return result;
+}
+
+uint64_t folderFingerprint(const string& folderPath)
+{
+    // a bundle is replaced as a whole: its own size and mtime are enough
+    if (isBundle(folderPath)) {
+        error_code ec;
+        const uint64_t size = (uint64_t)fs::file_size(folderPath, ec);
+        const int64_t mtime = (int64_t)fs::last_write_time(folderPath, ec).time_since_epoch().count();
+        return hashBytes(folderPath + '\n' + to_string(size) + ' ' + to_string(mtime) + '\n');
+    }
+    vector<string> paths;
+    vector<FileStamp> stamps;
+    listResumeFiles(folderPath, paths, stamps);
+    string all;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        all += paths[i];
+        all += '\n';
+        all += to_string(stamps[i].size) + ' ' + to_string(stamps[i].mtime) + '\n';
+    }
+    return hashBytes(all);
+}
+
+void streamResumesFromFolder(const string& folderPath, const IngestOptions& options, const function<void(Candidate&& c, int worker)>& sink)
+{
+    RF_ALLOC_STAGE(ALLOC_PARSE);
+    ResumeSource src;
+    listResumes(folderPath, src);
+    keepShard(options, src);
+    const vector<string>& paths = src.paths;
+    const size_t block = loadBlockSize(paths.size(), options.threads);
+    // the sink's own stage (scoring, for --top) takes over while it runs
+    parallelFor((paths.size() + block - 1) / block, options.threads, [&](size_t b, int worker) {
+        RF_ALLOC_STAGE(ALLOC_PARSE);
+        static thread_local vector<size_t> slots;
+        static thread_local vector<string> loaded;
+        static thread_local vector<FileLoadError> errors;
+        const size_t first = b * block;
+        const size_t count = min(paths.size() - first, block);
+        slots.resize(count);
+        for (size_t k = 0; k < count; ++k) slots[k] = first + k;
+        loaded.resize(count);
+        errors.resize(count);
+        loadResumes(src, slots.data(), count, loaded.data(), errors.data());
+        for (size_t k = 0; k < count; ++k) {
+            const string& path = paths[first + k];
+            Candidate c;
+            try {
+                if (checkLoad(path, errors[k])) {
+                    c.text = move(loaded[k]);
+                    parseResumeText(c, path);
+                }
+                else {
+                    c = emptyCandidate(path);
+                }
+            }
+            catch (const std::exception& e) {
+                logLine("Warning: failed to parse " + path + ": " + e.what());
+                c = emptyCandidate(path);
+            }
+            c.inputIndex = (uint32_t)(first + k);
+            sink(move(c), worker);
+        }
+    });
+}
+
+Job parseJobDescription(const string& jobFilePath)
+{
+    RF_TIMED_SCOPE("parse job");
+    RF_ALLOC_STAGE(ALLOC_JOB_PARSE);
+    ifstream in(jobFilePath);
+    if (!in.is_open()) {
+        cout << "Cannot open job description file: " << jobFilePath << "\n";
+        return Job();
+    }
+    const string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    return parseJobText(content);
+}
+
+Job parseJobText(string_view content)
+{
+    RF_ALLOC_STAGE(ALLOC_JOB_PARSE);
+    Job job;
+    // parse line-by-line for specific keys
+    string key;     // lowercase key of the current line, reused across lines
+    string scratch; // normalized skill name on its way to the interner
+    auto internItem = [&](string_view s) {
+        scratch.clear();
+        appendNormalizedSkill(scratch, s);
+        return internSkill(scratch);
+    };
+    string_view rest = content;
+    string_view ln;
+    while (nextLine(rest, ln)) {
+        string_view rawKey, val;
+        splitKeyValue(ln, rawKey, val);
+        key.clear();
+        appendLower(key, rawKey);
+        if (key.find("required skills") != string::npos || key == "required skills" || key == "required skill") {
+            forEachListItem(val, ",;|", [&](string_view s) { addSkill(job.requiredSkills, internItem(s)); });
+        }
+        else if (key.find("preferred skills") != string::npos || key == "preferred skills" || key == "preferred skill") {
+            forEachListItem(val, ",;|", [&](string_view s) { addSkill(job.preferredSkills, internItem(s)); });
+        }
+        else if (key.find("min gpa") != string::npos || key == "min gpa" || key == "min gpa:") {
+            double v = 0.0;
+            if (parseFirstNumber(val, v)) job.minGPA = v;
+        }
+        else if (key.find("min experience") != string::npos || key == "min experience") {
+            double v = 0.0;
+            if (parseFirstNumber(val, v)) job.minExperience = (int)v;
+        }
+        else if (key.find("required certifications") != string::npos || key.find("required certification") != string::npos) {
+            forEachListItem(val, ",;|", [&](string_view s) { job.requiredCerts.emplace_back(s); });
+        }
+        else if (key == "profile" || key == "scoring profile") {
+            if (!profileFromName(val, job.profile)) cout << "Unknown scoring profile \"" << val << "\", using " << profileWeights(job.profile).name << "\n";
+        }
+    }
+
+    // fallback keywords: extract words of length >= 4 from top of content
+    string_view prefix = content.substr(0, 1000);
+    forEachListItem(prefix, " ,.;:\n", [&](string_view t) {
+        if (t.size() < 4) return;
+        job.keywords.emplace_back();
+        appendLower(job.keywords.back(), t);
+    });
+
+    return job;
 }
\ No newline at end of file
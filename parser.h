@@ -1,37 +1,126 @@
-#ifndef PARSER_H
-#define PARSER_H
-
-#include <string>
-#include <vector>
-
-using namespace std;
-
-struct Candidate {
-    string name;
-    string education;
-    double gpa = -1.0;          // -1 means not found
-    vector<string> skills;
-    int experienceYears = 0;
-    vector<string> certifications;
-    string filepath;
-
-    // results filled by scoring stage
-    double score = 0.0;
-    char grade = 'D';
-    vector<string> matchedSkills;
-    vector<string> matchedCerts;
-};
-
-struct Job {
-    vector<string> requiredSkills;
-    vector<string> preferredSkills;
-    double minGPA = 0.0;
-    int minExperience = 0;
-    vector<string> requiredCerts;
-    vector<string> keywords;
-};
-
-vector<Candidate> parseResumesFromFolder(const string& folderPath);
-Job parseJobDescription(const string& jobFilePath);
-
-#endif // PARSER_H#pragma once
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "skilldict.h"
+#include "profiles.h"
+
+using namespace std;
+
+// A byte range inside Candidate::text. Offsets rather than pointers or string_views,
+// so a Candidate can be copied or moved (and its buffer reallocated) safely.
+struct TextSpan {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+struct Candidate {
+    // Every string field is a span into this one buffer: the resume bytes exactly as
+    // read, followed by the fallback certification names the parser adds and finally
+    // the source path. Skills are ids from the skill interner (skilldict.h).
+    string text;
+
+    TextSpan name;
+    TextSpan education;
+    double gpa = -1.0;          // -1 means not found
+    vector<uint32_t> skills;    // interned skill ids in resume order, no duplicates
+    int experienceYears = 0;
+    vector<TextSpan> certifications;
+    TextSpan filepath;
+    // position in the folder or bundle listing (after sharding); the last key when
+    // ranking, as a bundle can hold two entries under one path
+    uint32_t inputIndex = 0;
+
+    // results filled by scoring stage (skill ids / certification spans from above)
+    double score = 0.0;
+    char grade = 'D';
+    vector<uint32_t> matchedSkills;
+    vector<TextSpan> matchedCerts;
+};
+
+inline string_view spanText(const Candidate& c, TextSpan s)
+{
+    return string_view(c.text.data() + s.offset, s.length);
+}
+
+// the resume bytes and the names the parser derived from them, without the path
+inline string_view resumeText(const Candidate& c)
+{
+    return string_view(c.text.data(), c.filepath.offset);
+}
+
+struct Job {
+    SkillSet requiredSkills;
+    SkillSet preferredSkills;
+    double minGPA = 0.0;
+    int minExperience = 0;
+    vector<string> requiredCerts;
+    vector<string> keywords;
+    ScoringProfile profile = PROFILE_ENGINEERING;  // "Profile:" line, or --profile
+};
+
+struct IngestOptions {
+    int threads = 1;        // > 1 parses on a work-stealing pool; result order is unaffected
+    string cachePath;       // per-file parse cache; only new or changed files are parsed
+    uint32_t shard = 0;     // only files with shardOfFile(path, shardCount) == shard
+    uint32_t shardCount = 1;
+};
+
+// Which of shardCount shards a resume file belongs to. Hashes the file name only, so
+// processes that see the folder under different paths still agree on the split.
+uint32_t shardOfFile(const string& path, uint32_t shardCount);
+
+// What the ingest cache remembers about the file a candidate was parsed from.
+struct FileStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;      // filesystem clock ticks, only compared for equality
+    uint64_t hash = 0;      // hashBytes() of the file contents
+};
+
+// cache bookkeeping of one parseResumesFromFolder call
+struct IngestStats {
+    size_t cacheHits = 0;       // reused without parsing
+    size_t cacheMisses = 0;     // new, changed or unreadable files (parsed from scratch)
+    size_t cacheEvicted = 0;    // cached files that are gone from the folder
+};
+
+// Parses every .txt file in the folder; the result is always in directory order.
+// stamps, if given, gets each result's FileStamp. The mtime is the one listed before
+// the file was read, so a file rewritten during the call shows up as changed later.
+vector<Candidate> parseResumesFromFolder(const string& folderPath, const IngestOptions& options = IngestOptions(),
+                                         IngestStats* stats = nullptr, vector<FileStamp>* stamps = nullptr);
+// Parses the same files as parseResumesFromFolder but hands each candidate to
+// sink(c, worker) as soon as it is parsed instead of collecting them, so the caller
+// decides what to keep. sink runs on the parsing workers (worker < options.threads)
+// in no particular order. The ingest cache is not used.
+void streamResumesFromFolder(const string& folderPath, const IngestOptions& options, const function<void(Candidate&& c, int worker)>& sink);
+Job parseJobDescription(const string& jobFilePath);
+// Same as parseJobDescription for job text already in memory.
+Job parseJobText(string_view content);
+
+// Hash of the names, sizes and mtimes of the .txt files in the folder; changes
+// whenever parseResumesFromFolder would see a different set of files.
+uint64_t folderFingerprint(const string& folderPath);
+
+// Reads and parses one resume; an unreadable or broken file gives a candidate with only
+// its path set (and *failed = true). Used by the folder parsers and the benchmarks.
+Candidate parseResumeFile(const string& path, bool* failed = nullptr);
+
+// First number in s (integer or decimal); a fraction like 9.0/10 wins over a plain
+// number and is normalized to a 4.0 scale. Returns true if found.
+bool parseFirstNumber(string_view s, double& out);
+
+// Replaces the built-in known skill / certification names used when a resume has no
+// skills line and for spotting certifications anywhere in the text. The file has
+// "[skills]" and "[certifications]" sections, one name per line, '#' comments, and an
+// optional "[aliases]" section of "alias = skill" lines that replaces the skill alias
+// table (skillalias.h). Call before parsing starts; the parser threads read the
+// dictionary unlocked.
+bool loadDictionary(const string& path);
+
+#endif // PARSER_H#pragma once
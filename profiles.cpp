@@ -0,0 +1,24 @@
+#include "profiles.h"
+#include "utils.h"
+
+using namespace std;
+
+const ProfileWeights& profileWeights(ScoringProfile profile)
+{
+    switch (profile) {
+    case PROFILE_INTERN: return InternProfile::weights;
+    case PROFILE_MANAGEMENT: return ManagementProfile::weights;
+    default: return EngineeringProfile::weights;
+    }
+}
+
+bool profileFromName(string_view name, ScoringProfile& out)
+{
+    for (int p = 0; p < PROFILE_COUNT; ++p) {
+        if (equalsNoCase(trimView(name), profileWeights((ScoringProfile)p).name)) {
+            out = (ScoringProfile)p;
+            return true;
+        }
+    }
+    return false;
+}
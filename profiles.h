@@ -0,0 +1,53 @@
+#ifndef PROFILES_H
+#define PROFILES_H
+
+#include <string_view>
+
+using namespace std;
+
+// Weights and grade thresholds of one scoring profile. The five weights add up to 100.
+struct ProfileWeights {
+    const char* name;
+    double skills;
+    double experience;
+    double gpa;
+    double certs;
+    double keywords;
+    double requiredShare;       // part of the skills points for required skills
+    double preferredShare;      // part of the skills points for preferred skills
+    double noSkillsShare;       // part of the skills points given when the job lists none
+    double maxExperience;       // years counted when the job sets no minimum
+    double gradeA;              // lowest score for each grade
+    double gradeB;
+    double gradeC;
+};
+
+enum ScoringProfile {
+    PROFILE_ENGINEERING,
+    PROFILE_INTERN,
+    PROFILE_MANAGEMENT,
+    PROFILE_COUNT
+};
+
+// Policy types, one per profile. The scorer instantiates its kernels for each of them,
+// so the weights are compile-time constants inside the candidate loop.
+struct EngineeringProfile {
+    // the original static weights
+    static constexpr ProfileWeights weights = { "engineering", 50.0, 20.0, 15.0, 10.0, 5.0, 0.7, 0.3, 0.2, 10.0, 85.0, 70.0, 55.0 };
+};
+
+struct InternProfile {
+    // little experience expected: grades and keywords count for more
+    static constexpr ProfileWeights weights = { "intern", 45.0, 5.0, 25.0, 5.0, 20.0, 0.6, 0.4, 0.3, 2.0, 80.0, 65.0, 50.0 };
+};
+
+struct ManagementProfile {
+    // experience first; required and preferred skills weigh the same
+    static constexpr ProfileWeights weights = { "management", 30.0, 35.0, 5.0, 15.0, 15.0, 0.5, 0.5, 0.3, 15.0, 85.0, 70.0, 55.0 };
+};
+
+const ProfileWeights& profileWeights(ScoringProfile profile);
+// case-insensitive profile name; false if unknown
+bool profileFromName(string_view name, ScoringProfile& out);
+
+#endif // PROFILES_H
@@ -0,0 +1,137 @@
+#include "ranking.h"
+#include "stats.h"
+#include "allocstats.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <numeric>
+
+using namespace std;
+
+bool rankBefore(const Candidate& a, const Candidate& b)
+{
+    if (a.score != b.score) return a.score > b.score;
+    const string_view pa = spanText(a, a.filepath), pb = spanText(b, b.filepath);
+    if (pa != pb) return pa < pb;
+    return a.inputIndex < b.inputIndex;
+}
+
+// below this many entries per thread a plain sort beats splitting the work
+static const size_t PARALLEL_SORT_MIN = 16384;
+
+void rankPool(CandidatePool& pool, int threads)
+{
+    RF_TIMED_SCOPE("rank pool");
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    const size_t n = poolSize(pool);
+    auto before = [&](uint32_t a, uint32_t b) {
+        if (pool.score[a] != pool.score[b]) return pool.score[a] > pool.score[b];
+        const string_view pa = poolText(pool, pool.filepath[a]), pb = poolText(pool, pool.filepath[b]);
+        if (pa != pb) return pa < pb;
+        return a < b;
+    };
+    vector<uint32_t>& order = pool.rankOrder;
+    order.resize(n);
+    iota(order.begin(), order.end(), 0u);
+
+    const size_t runs = threads > 1 ? min((size_t)threads, n / PARALLEL_SORT_MIN) : 1;
+    if (runs <= 1) {
+        sort(order.begin(), order.end(), before);
+        return;
+    }
+    // sort `runs` equal slices, then merge neighbouring runs pairwise until one is left
+    vector<size_t> bounds(runs + 1);
+    for (size_t r = 0; r <= runs; ++r) bounds[r] = n * r / runs;
+    parallelFor(runs, threads, [&](size_t r, int) {
+        sort(order.begin() + bounds[r], order.begin() + bounds[r + 1], before);
+    });
+    vector<uint32_t> merged(n);
+    while (bounds.size() > 2) {
+        const size_t pairs = (bounds.size() - 1) / 2;
+        parallelFor(pairs, threads, [&](size_t k, int) {
+            const size_t lo = bounds[2 * k], mid = bounds[2 * k + 1], hi = bounds[2 * k + 2];
+            merge(order.begin() + lo, order.begin() + mid, order.begin() + mid, order.begin() + hi, merged.begin() + lo, before);
+        });
+        // an odd run out stays where it is
+        if ((bounds.size() - 1) % 2 != 0) copy(order.begin() + bounds[bounds.size() - 2], order.end(), merged.begin() + bounds[bounds.size() - 2]);
+        vector<size_t> next;
+        for (size_t r = 0; r < bounds.size(); r += 2) next.push_back(bounds[r]);
+        if (next.back() != n) next.push_back(n);
+        bounds = move(next);
+        order.swap(merged);
+    }
+}
+
+vector<size_t> topPoolEntries(const CandidatePool& pool, const double* scores, size_t k)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    const size_t n = poolSize(pool);
+    vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    k = min(k, n);
+    partial_sort(order.begin(), order.begin() + k, order.end(), [&](size_t a, size_t b) {
+        if (scores[a] != scores[b]) return scores[a] > scores[b];
+        const string_view pa = poolText(pool, pool.filepath[a]), pb = poolText(pool, pool.filepath[b]);
+        if (pa != pb) return pa < pb;
+        return a < b;
+    });
+    order.resize(k);
+    return order;
+}
+
+void countGrade(GradeCounts& counts, char grade)
+{
+    counts.total++;
+    switch (grade) {
+    case 'A': counts.byGrade[0]++; break;
+    case 'B': counts.byGrade[1]++; break;
+    case 'C': counts.byGrade[2]++; break;
+    default:  counts.byGrade[3]++; break;
+    }
+}
+
+void mergeGradeCounts(GradeCounts& into, const GradeCounts& from)
+{
+    into.total += from.total;
+    for (int g = 0; g < 4; ++g) into.byGrade[g] += from.byGrade[g];
+}
+
+// keep the weakest candidate at the front: with rankBefore as "less", the heap's
+// maximum is the candidate that ranks behind all the others
+static void keepBest(TopK& top, Candidate&& c)
+{
+    if (top.k == 0) return;
+    if (top.heap.size() < top.k) {
+        top.heap.push_back(move(c));
+        push_heap(top.heap.begin(), top.heap.end(), rankBefore);
+    }
+    else if (rankBefore(c, top.heap.front())) {
+        pop_heap(top.heap.begin(), top.heap.end(), rankBefore);
+        top.heap.back() = move(c);
+        push_heap(top.heap.begin(), top.heap.end(), rankBefore);
+    }
+}
+
+void offerCandidate(TopK& top, Candidate&& c)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    countGrade(top.counts, c.grade);
+    keepBest(top, move(c));
+}
+
+void mergeTopK(TopK& into, TopK&& from)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    mergeGradeCounts(into.counts, from.counts);
+    for (auto& c : from.heap) keepBest(into, move(c));
+    from.heap.clear();
+    from.counts = GradeCounts();
+}
+
+vector<Candidate> takeRanked(TopK& top)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    vector<Candidate> ranked = move(top.heap);
+    top.heap.clear();
+    sort(ranked.begin(), ranked.end(), rankBefore);
+    return ranked;
+}
@@ -0,0 +1,50 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include "parser.h"
+#include "candidatepool.h"
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+// true if a ranks ahead of b: higher score first, ties broken by source path and then
+// by inputIndex, so the order never depends on directory or thread scheduling order
+bool rankBefore(const Candidate& a, const Candidate& b);
+
+// Sorts the pool's entries into rankOrder: higher score first, then by source path,
+// then by entry (for bundles, where two entries can share a path). With threads > 1
+// the runs are sorted and merged in parallel; the order is total, so the result is
+// the same for any thread count.
+void rankPool(CandidatePool& pool, int threads = 1);
+
+// Indexes of the k best pool entries given their scores (scores[i] for entry i), best
+// first, in rankPool order. The pool itself is only read.
+vector<size_t> topPoolEntries(const CandidatePool& pool, const double* scores, size_t k);
+
+// how many scored candidates fell into each grade
+struct GradeCounts {
+    size_t total = 0;
+    size_t byGrade[4] = {};     // A, B, C, D
+};
+
+void countGrade(GradeCounts& counts, char grade);
+void mergeGradeCounts(GradeCounts& into, const GradeCounts& from);
+
+// The best k candidates offered so far plus grade counts over all of them. Everything
+// outside the top k is dropped as soon as it is offered, so memory stays at k
+// candidates however many are streamed through.
+struct TopK {
+    size_t k = 0;
+    vector<Candidate> heap;     // heap with the weakest kept candidate at the front
+    GradeCounts counts;
+};
+
+// c must already be scored
+void offerCandidate(TopK& top, Candidate&& c);
+// moves everything kept in `from` into `into` (same k)
+void mergeTopK(TopK& into, TopK&& from);
+// the kept candidates, best first; leaves the heap empty
+vector<Candidate> takeRanked(TopK& top);
+
+#endif // RANKING_H
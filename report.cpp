@@ -1,64 +1,248 @@
-#include "report.h"
-#include <fstream>
-#include <iomanip>
-
-using namespace std;
-
-// static threshold: select B or above
-static bool isSelected(const Candidate& c) {
-    return (c.grade == 'A' || c.grade == 'B');
-}
-
-bool writeReport(const string& outPath, const vector<Candidate>& candidates, const Job& job)
-{
-    ofstream out(outPath);
-    if (!out.is_open()) return false;
-
-    out << "Selected Candidates Report\n";
-    out << "==========================\n\n";
-    out << "Criteria used (static):\n";
-    out << "- Grades considered: A, B\n";
-    out << "- Weights: Skills 50, Experience 20, GPA 15, Certs 10, Keywords 5\n\n";
-
-    int total = 0, selected = 0;
-    for (auto& c : candidates) {
-        total++;
-        if (isSelected(c)) {
-            selected++;
-            out << "Name: " << c.name << "\n";
-            out << "Score: " << fixed << setprecision(1) << c.score << "   Grade: " << c.grade << "\n";
-            out << "Experience (years): " << c.experienceYears << "\n";
-            out << "GPA: " << ((c.gpa > 0.0) ? to_string(c.gpa) : string("N/A")) << "\n";
-
-            out << "Matched Skills: ";
-            if (c.matchedSkills.empty()) out << "None";
-            else {
-                for (size_t i = 0; i < c.matchedSkills.size(); ++i) {
-                    if (i) out << ", ";
-                    out << c.matchedSkills[i];
-                }
-            }
-            out << "\n";
-
-            out << "Matched Certifications: ";
-            if (c.matchedCerts.empty()) out << "None";
-            else {
-                for (size_t i = 0; i < c.matchedCerts.size(); ++i) {
-                    if (i) out << ", ";
-                    out << c.matchedCerts[i];
-                }
-            }
-            out << "\n";
-
-            out << "Source file: " << c.filepath << "\n";
-            out << "--------------------------\n";
-        }
-    }
-
-    out << "\nSummary:\n";
-    out << "Total candidates processed: " << total << "\n";
-    out << "Selected (A or B): " << selected << "\n";
-
-    out.close();
-    return true;
-}
\ No newline at end of file
+#include "report.h"
+#include "stats.h"
+#include "allocstats.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+using namespace std;
+
+// static threshold: select B or above
+static bool isSelected(char grade) {
+    return (grade == 'A' || grade == 'B');
+}
+
+static double percentOf(uint64_t part, uint64_t whole)
+{
+    return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static void writeComponent(ofstream& out, const char* label, const ScoreSketch& s, const ComponentHistogram& h)
+{
+    out << "- " << label << ": mean " << componentMean(s, h) << " of " << h.max << "; by tenth:";
+    for (uint64_t n : h.bins) out << " " << n;
+    out << "\n";
+}
+
+// score distribution, components and missing skills over every candidate scored
+static void writeSketchSummary(ofstream& out, const ScoreSketch& s)
+{
+    out << fixed << setprecision(1);
+    out << "\nScore distribution (all " << s.count << " candidates scored):\n";
+    out << "- Mean: " << sketchMean(s) << "\n";
+    out << "- Percentiles: p10 " << sketchPercentile(s, 0.10) << ", p25 " << sketchPercentile(s, 0.25)
+        << ", p50 " << sketchPercentile(s, 0.50) << ", p75 " << sketchPercentile(s, 0.75)
+        << ", p90 " << sketchPercentile(s, 0.90) << ", p99 " << sketchPercentile(s, 0.99) << "\n";
+    const size_t perBucket = SCORE_BINS / 10;
+    for (size_t b = 10; b-- > 0;) {
+        uint64_t n = 0;
+        for (size_t k = b * perBucket; k < (b + 1) * perBucket; ++k) n += s.scoreBins[k];
+        out << "- " << b * 10 << "-" << b * 10 + 10 << ": " << n << " (" << percentOf(n, s.count) << "%)\n";
+    }
+
+    out << "\nScore components (candidates per tenth of the component's points, lowest first):\n";
+    writeComponent(out, "Skills", s, s.skills);
+    writeComponent(out, "Experience", s, s.experience);
+    writeComponent(out, "GPA", s, s.gpa);
+    writeComponent(out, "Certs", s, s.certs);
+
+    vector<size_t> order;
+    for (size_t r = 0; r < s.requiredSkills.size(); ++r) {
+        if (s.missing[r] > 0) order.push_back(r);
+    }
+    if (order.empty()) return;
+    // most often missing first; ties by name so the list is the same in every process
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (s.missing[a] != s.missing[b]) return s.missing[a] > s.missing[b];
+        return skillName(s.requiredSkills[a]) < skillName(s.requiredSkills[b]);
+    });
+    if (order.size() > 10) order.resize(10);
+    out << "\nRequired skills most often missing:\n";
+    for (size_t r : order) {
+        out << "- " << skillName(s.requiredSkills[r]) << ": " << s.missing[r] << " (" << percentOf(s.missing[r], s.count) << "%)\n";
+    }
+}
+
+static void writeCriteria(ofstream& out, const Job& job)
+{
+    out << "Selected Candidates Report\n";
+    out << "==========================\n\n";
+    out << "Criteria used (static):\n";
+    const ProfileWeights& w = profileWeights(job.profile);
+    out << "- Grades considered: A, B\n";
+    out << "- Profile: " << w.name << "\n";
+    out << "- Weights: Skills " << w.skills << ", Experience " << w.experience << ", GPA " << w.gpa
+        << ", Certs " << w.certs << ", Keywords " << w.keywords << "\n\n";
+}
+
+// pool entry c, in the same form as a Candidate below
+static void writeEntry(ofstream& out, const CandidatePool& pool, size_t c)
+{
+    out << "Name: " << poolText(pool, pool.name[c]) << "\n";
+    out << "Score: " << fixed << setprecision(1) << pool.score[c] << "   Grade: " << pool.grade[c] << "\n";
+    out << "Experience (years): " << pool.years[c] << "\n";
+    out << "GPA: " << ((pool.gpa[c] > 0.0) ? to_string(pool.gpa[c]) : string("N/A")) << "\n";
+
+    out << "Matched Skills: ";
+    if (pool.matchedSkillStart[c] == pool.matchedSkillStart[c + 1]) out << "None";
+    else {
+        for (uint32_t i = pool.matchedSkillStart[c]; i < pool.matchedSkillStart[c + 1]; ++i) {
+            if (i != pool.matchedSkillStart[c]) out << ", ";
+            out << skillName(pool.matchedSkillIds[i]);
+        }
+    }
+    out << "\n";
+
+    out << "Matched Certifications: ";
+    if (pool.matchedCertStart[c] == pool.matchedCertStart[c + 1]) out << "None";
+    else {
+        for (uint32_t i = pool.matchedCertStart[c]; i < pool.matchedCertStart[c + 1]; ++i) {
+            if (i != pool.matchedCertStart[c]) out << ", ";
+            out << poolText(pool, pool.certs[pool.matchedCerts[i]]);
+        }
+    }
+    out << "\n";
+
+    out << "Source file: " << poolText(pool, pool.filepath[c]) << "\n";
+    if (pool.duplicateStart[c] != pool.duplicateStart[c + 1]) {
+        out << "Duplicates: ";
+        for (uint32_t i = pool.duplicateStart[c]; i < pool.duplicateStart[c + 1]; ++i) {
+            if (i != pool.duplicateStart[c]) out << ", ";
+            out << poolText(pool, pool.duplicates[i]);
+        }
+        out << "\n";
+    }
+    out << "--------------------------\n";
+}
+
+static void writeEntry(ofstream& out, const Candidate& c)
+{
+    out << "Name: " << spanText(c, c.name) << "\n";
+    out << "Score: " << fixed << setprecision(1) << c.score << "   Grade: " << c.grade << "\n";
+    out << "Experience (years): " << c.experienceYears << "\n";
+    out << "GPA: " << ((c.gpa > 0.0) ? to_string(c.gpa) : string("N/A")) << "\n";
+
+    out << "Matched Skills: ";
+    if (c.matchedSkills.empty()) out << "None";
+    for (size_t i = 0; i < c.matchedSkills.size(); ++i) {
+        if (i) out << ", ";
+        out << skillName(c.matchedSkills[i]);
+    }
+    out << "\n";
+
+    out << "Matched Certifications: ";
+    if (c.matchedCerts.empty()) out << "None";
+    for (size_t i = 0; i < c.matchedCerts.size(); ++i) {
+        if (i) out << ", ";
+        out << spanText(c, c.matchedCerts[i]);
+    }
+    out << "\n";
+
+    out << "Source file: " << spanText(c, c.filepath) << "\n";
+    out << "--------------------------\n";
+}
+
+static void writeSummary(ofstream& out, size_t total, size_t selected, const GradeCounts* counts,
+                         size_t duplicates, const ScoreSketch& sketch)
+{
+    out << "\nSummary:\n";
+    if (counts) {
+        out << "Total candidates processed: " << counts->total << "\n";
+        out << "Selected (A or B): " << counts->byGrade[0] + counts->byGrade[1] << "\n";
+        out << "Only the top " << total << " by score were kept for this report\n";
+    }
+    else {
+        out << "Total candidates processed: " << total << "\n";
+        out << "Selected (A or B): " << selected << "\n";
+    }
+    if (duplicates) {
+        out << "Near-duplicate resumes listed under another candidate: " << duplicates << "\n";
+    }
+    if (sketch.count > 0) writeSketchSummary(out, sketch);
+}
+
+bool writeReport(const string& outPath, const CandidatePool& pool, const Job& job, const GradeCounts* counts)
+{
+    RF_TIMED_SCOPE("write report");
+    RF_ALLOC_STAGE(ALLOC_REPORT);
+    ofstream out(outPath);
+    if (!out.is_open()) return false;
+
+    writeCriteria(out, job);
+    const size_t total = poolSize(pool);
+    size_t selected = 0;
+    for (size_t r = 0; r < total; ++r) {
+        const size_t c = entryAtRank(pool, r);
+        if (!isSelected(pool.grade[c])) continue;
+        selected++;
+        writeEntry(out, pool, c);
+    }
+    writeSummary(out, total, selected, counts, pool.duplicates.size(), pool.sketch);
+
+    out.close();
+    return true;
+}
+
+bool writeReport(const string& outPath, const vector<const Candidate*>& ranked, const Job& job, const ScoreSketch& sketch)
+{
+    RF_TIMED_SCOPE("write report");
+    RF_ALLOC_STAGE(ALLOC_REPORT);
+    ofstream out(outPath);
+    if (!out.is_open()) return false;
+
+    writeCriteria(out, job);
+    size_t selected = 0;
+    for (const Candidate* c : ranked) {
+        if (!isSelected(c->grade)) continue;
+        selected++;
+        writeEntry(out, *c);
+    }
+    writeSummary(out, ranked.size(), selected, nullptr, 0, sketch);
+
+    out.close();
+    return true;
+}
+
+bool writeReport(const string& outPath, const vector<Candidate>& candidates, const Job& job, const GradeCounts* counts)
+{
+    RF_ALLOC_STAGE(ALLOC_REPORT);
+    CandidatePool pool;
+    for (auto& c : candidates) addToPool(pool, c);
+    return writeReport(outPath, pool, job, counts);
+}
+
+// quote a CSV field when it holds a separator, quote or line break
+static string csvField(string_view s)
+{
+    if (s.find_first_of(",\"\r\n") == string_view::npos) return string(s);
+    string out = "\"";
+    for (char ch : s) {
+        if (ch == '"') out += '"';
+        out += ch;
+    }
+    out += '"';
+    return out;
+}
+
+bool writeScoreMatrix(const string& outPath, const vector<Candidate>& candidates, const vector<string>& jobNames, const ScoreMatrix& m)
+{
+    RF_TIMED_SCOPE("write score matrix");
+    RF_ALLOC_STAGE(ALLOC_REPORT);
+    ofstream out(outPath);
+    if (!out.is_open()) return false;
+
+    out << "name,source";
+    for (auto& j : jobNames) out << "," << csvField(j);
+    out << "\n";
+    for (size_t i = 0; i < m.candidateCount; ++i) {
+        const Candidate& c = candidates[i];
+        out << csvField(spanText(c, c.name)) << "," << csvField(spanText(c, c.filepath));
+        for (size_t j = 0; j < m.jobCount; ++j) {
+            out << "," << fixed << setprecision(2) << m.scores[j * m.candidateCount + i];
+        }
+        out << "\n";
+    }
+
+    out.close();
+    return true;
+}
@@ -1,12 +1,24 @@
-#ifndef REPORT_H
-#define REPORT_H
-
-#include "parser.h"
-#include <string>
-#include <vector>
-
-using namespace std;
-
-bool writeReport(const string& outPath, const vector<Candidate>& candidates, const Job& job);
-
-#endif // REPORT_H#pragma once
+#ifndef REPORT_H
+#define REPORT_H
+
+#include "parser.h"
+#include "scorer.h"
+#include "ranking.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// With counts (from a top-K run) the candidates are only the ones kept, and the
+// summary totals come from counts instead of the list. Duplicate paths recorded in
+// the pool (--dedupe) are listed under their candidate.
+bool writeReport(const string& outPath, const CandidatePool& pool, const Job& job, const GradeCounts* counts = nullptr);
+bool writeReport(const string& outPath, const vector<Candidate>& candidates, const Job& job, const GradeCounts* counts = nullptr);
+// The same report straight from scored candidates already in rank order, without
+// copying them into a pool first (--watch rewrites it after every change).
+bool writeReport(const string& outPath, const vector<const Candidate*>& ranked, const Job& job, const ScoreSketch& sketch);
+
+// CSV with one row per candidate and one score column per job file
+bool writeScoreMatrix(const string& outPath, const vector<Candidate>& candidates, const vector<string>& jobNames, const ScoreMatrix& m);
+
+#endif // REPORT_H#pragma once
@@ -1,185 +1,719 @@
-#include "scorer.h"
-#include "utils.h"
-#include <algorithm>
-#include <cmath>
-
-using namespace std;
-
-/*
- Scoring strategy (static weights):
- - Skills: 50 points (required skills weighted higher)
- - Experience: 20 points
- - GPA: 15 points
- - Certifications: 10 points
- - Keywords/other: 5 points
-
- Mapping:
- 85-100 -> A
- 70-84  -> B
- 55-69  -> C
- <55    -> D
-
- Note: thresholds and weights are static as requested.
-*/
-
-static const double SKILLS_WEIGHT = 50.0;
-static const double EXPERIENCE_WEIGHT = 20.0;
-static const double GPA_WEIGHT = 15.0;
-static const double CERT_WEIGHT = 10.0;
-static const double KEYWORD_WEIGHT = 5.0;
-
-static const double MAX_EXPERIENCE_CONSIDERED = 10.0; // cap years to avoid huge advantage
-
-// helper to compute intersection size (normalized)
-static vector<string> intersectNormalized(const vector<string>& a, const vector<string>& b)
-{
-    vector<string> res;
-    for (auto& x : a) {
-        string nx = normalizeSkill(x);
-        for (auto& y : b) {
-            string ny = normalizeSkill(y);
-            if (nx == ny) {
-                res.push_back(nx);
-                break;
-            }
-        }
-    }
-    return res;
-}
-
-void scoreAllCandidates(vector<Candidate>& candidates, const Job& job)
-{
-    for (auto& c : candidates) {
-        double score = 0.0;
-
-        // Skills scoring
-        int reqCount = (int)job.requiredSkills.size();
-        int prefCount = (int)job.preferredSkills.size();
-        double skillsScore = 0.0;
-
-        if (reqCount + prefCount == 0) {
-            // no skill info in job -> small default
-            skillsScore = SKILLS_WEIGHT * 0.2;
-        }
-        else {
-            // required matches
-            vector<string> reqMatched = intersectNormalized(c.skills, job.requiredSkills);
-            vector<string> prefMatched = intersectNormalized(c.skills, job.preferredSkills);
-
-            // required share gets bigger portion of SKILLS_WEIGHT
-            double reqPart = SKILLS_WEIGHT * 0.7;
-            double prefPart = SKILLS_WEIGHT * 0.3;
-
-            if (reqCount > 0) {
-                skillsScore += reqPart * ((double)reqMatched.size() / (double)reqCount);
-            }
-            if (prefCount > 0) {
-                skillsScore += prefPart * ((double)prefMatched.size() / (double)prefCount);
-            }
-
-            // record matched skills names (unique)
-            c.matchedSkills = reqMatched;
-            for (auto& ps : prefMatched) {
-                bool found = false;
-                for (auto& x : c.matchedSkills) if (x == ps) { found = true; break; }
-                if (!found) c.matchedSkills.push_back(ps);
-            }
-        }
-        score += skillsScore;
-
-        // Experience scoring
-        double expScore = 0.0;
-        double years = (double)c.experienceYears;
-        if (years > 0) {
-            double cap = min(years, MAX_EXPERIENCE_CONSIDERED);
-            // if job.minExperience present, give full points when >= minExperience
-            if (job.minExperience > 0) {
-                if (years >= job.minExperience) {
-                    expScore = EXPERIENCE_WEIGHT;
-                }
-                else {
-                    // proportion of required
-                    expScore = EXPERIENCE_WEIGHT * (years / (double)job.minExperience);
-                }
-            }
-            else {
-                // otherwise scale to cap
-                expScore = EXPERIENCE_WEIGHT * (cap / MAX_EXPERIENCE_CONSIDERED);
-            }
-        }
-        score += expScore;
-
-        // GPA scoring
-        double gpaScore = 0.0;
-        if (c.gpa > 0.0) {
-            if (job.minGPA > 0.0) {
-                if (c.gpa >= job.minGPA) gpaScore = GPA_WEIGHT;
-                else {
-                    // partial proportional; assume 0..job.minGPA maps to 0..GPA_WEIGHT
-                    double ratio = c.gpa / job.minGPA;
-                    ratio = max(0.0, min(1.0, ratio));
-                    gpaScore = GPA_WEIGHT * ratio;
-                }
-            }
-            else {
-                // no job min -> give partial based on 4.0 scale
-                double ratio = min(c.gpa / 4.0, 1.0);
-                gpaScore = GPA_WEIGHT * ratio;
-            }
-        }
-        score += gpaScore;
-
-        // Certifications scoring
-        double certScore = 0.0;
-        if (!job.requiredCerts.empty()) {
-            for (auto& rc : job.requiredCerts) {
-                for (auto& pc : c.certifications) {
-                    if (containsToken(toLower(pc), toLower(rc))) {
-                        certScore += CERT_WEIGHT / (double)job.requiredCerts.size();
-                        c.matchedCerts.push_back(pc);
-                    }
-                }
-            }
-        }
-        else {
-            // give some credit for any certification
-            if (!c.certifications.empty()) certScore = min(CERT_WEIGHT, (double)c.certifications.size() * 2.0);
-        }
-        score += certScore;
-
-        // Keywords/other
-        double keywordScore = 0.0;
-        int matchedKW = 0;
-        for (auto& kw : job.keywords) {
-            if (containsToken(toLower(c.filepath), kw)) matchedKW++;
-            // also could search other fields, but keep simple:
-            if (containsToken(toLower(c.name), kw)) matchedKW++;
-        }
-        if (!job.keywords.empty()) {
-            // small bonus proportional to matched keywords
-            keywordScore = KEYWORD_WEIGHT * ((double)matchedKW / (double)max(1, (int)job.keywords.size()));
-            if (keywordScore > KEYWORD_WEIGHT) keywordScore = KEYWORD_WEIGHT;
-        }
-        score += keywordScore;
-
-        // final clamp
-        if (score > 100.0) score = 100.0;
-        if (score < 0.0) score = 0.0;
-
-        c.score = score;
-        c.grade = letterFromScore(score);
-    }
-}
-
-double gradeFromScore(double score)
-{
-    return score; // placeholder: scores are numeric; grading done by letterFromScore
-}
-
-char letterFromScore(double score)
-{
-    if (score >= 85.0) return 'A';
-    if (score >= 70.0) return 'B';
-    if (score >= 55.0) return 'C';
-    return 'D';
+#include "scorer.h"
+#include "utils.h"
+#include "stats.h"
+#include "allocstats.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+/*
+ Scoring strategy (weights per profile, see profiles.h; engineering shown):
+ - Skills: 50 points (required skills weighted higher)
+ - Experience: 20 points
+ - GPA: 15 points
+ - Certifications: 10 points
+ - Keywords/other: 5 points (BM25 relevance of the resume text to the job's keywords)
+
+ Mapping:
+ 85-100 -> A
+ 70-84  -> B
+ 55-69  -> C
+ <55    -> D
+
+ Each profile is a policy type with constexpr weights. Per job, prepareScorer picks a
+ kernel instantiated for that profile and for which criteria the job sets (skills,
+ minimum experience, minimum GPA, required certifications), so the candidate loop
+ carries neither those branches nor weight loads.
+*/
+
+// ---- per-component scoring, shared by every kernel and the batch path ----
+
+// The component helpers take plain views of a candidate's fields, so the Candidate
+// path and the CandidatePool path share them. The split ones (...WithMin / ...Scaled)
+// are the two sides of a per-job branch; the kernels call the side their job needs.
+
+// popcount(candidate AND job set) for required and preferred skills. Candidate ids are
+// unique, so walking the short sparse id list against the job's bitsets gives that
+// without building a dense bitset per candidate. If `matched` is given it receives the
+// matched ids in resume order: required first, then preferred-only ones.
+static void countSkillMatches(const uint32_t* skills, size_t count, const Job& job, size_t& reqMatched, size_t& prefMatched, vector<uint32_t>* matched)
+{
+    reqMatched = 0;
+    prefMatched = 0;
+    RF_STAT_ADD(STAT_SKILL_COMPARISONS, 2 * count);
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t id = skills[k];
+        if (hasSkill(job.requiredSkills, id)) {
+            if (matched) matched->push_back(id);
+            reqMatched++;
+        }
+    }
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t id = skills[k];
+        if (hasSkill(job.preferredSkills, id)) {
+            prefMatched++;
+            if (matched && !hasSkill(job.requiredSkills, id)) matched->push_back(id);
+        }
+    }
+}
+
+// no skill info in job -> small default
+static inline double skillsDefault(const ProfileWeights& w)
+{
+    return w.skills * w.noSkillsShare;
+}
+
+static inline double skillsFromMatches(const ProfileWeights& w, double reqMatched, double prefMatched, int reqCount, int prefCount)
+{
+    // required share gets bigger portion of the skills points
+    double reqPart = w.skills * w.requiredShare;
+    double prefPart = w.skills * w.preferredShare;
+    double skillsScore = 0.0;
+    if (reqCount > 0) {
+        skillsScore += reqPart * (reqMatched / (double)reqCount);
+    }
+    if (prefCount > 0) {
+        skillsScore += prefPart * (prefMatched / (double)prefCount);
+    }
+    return skillsScore;
+}
+
+static inline double skillsFromCounts(const ProfileWeights& w, double reqMatched, double prefMatched, int reqCount, int prefCount)
+{
+    if (reqCount + prefCount == 0) return skillsDefault(w);
+    return skillsFromMatches(w, reqMatched, prefMatched, reqCount, prefCount);
+}
+
+// job sets a minimum: full points when met, else the proportion of it
+static inline double experienceWithMin(const ProfileWeights& w, double years, int minExperience)
+{
+    if (!(years > 0)) return 0.0;
+    if (years >= minExperience) return w.experience;
+    return w.experience * (years / (double)minExperience);
+}
+
+// no minimum: scale up to the profile's cap
+static inline double experienceScaled(const ProfileWeights& w, double years)
+{
+    if (!(years > 0)) return 0.0;
+    double cap = min(years, w.maxExperience);
+    return w.experience * (cap / w.maxExperience);
+}
+
+static inline double experienceComponent(const ProfileWeights& w, double years, int minExperience)
+{
+    return minExperience > 0 ? experienceWithMin(w, years, minExperience) : experienceScaled(w, years);
+}
+
+// partial proportional; assume 0..job.minGPA maps to 0..the GPA points
+static inline double gpaWithMin(const ProfileWeights& w, double gpa, double minGPA)
+{
+    if (!(gpa > 0.0)) return 0.0;
+    if (gpa >= minGPA) return w.gpa;
+    double ratio = gpa / minGPA;
+    ratio = max(0.0, min(1.0, ratio));
+    return w.gpa * ratio;
+}
+
+// no job min -> give partial based on 4.0 scale
+static inline double gpaScaled(const ProfileWeights& w, double gpa)
+{
+    if (!(gpa > 0.0)) return 0.0;
+    double ratio = min(gpa / 4.0, 1.0);
+    return w.gpa * ratio;
+}
+
+static inline double gpaComponent(const ProfileWeights& w, double gpa, double minGPA)
+{
+    return minGPA > 0.0 ? gpaWithMin(w, gpa, minGPA) : gpaScaled(w, gpa);
+}
+
+// `matched` receives the index (into certs) of every matching certification
+static double certRequired(const ProfileWeights& w, const string_view* certs, size_t count, JobScorer& ctx, vector<uint32_t>* matched)
+{
+    // one automaton pass per candidate cert finds every required cert in it;
+    // credit is then given required-cert first, as before
+    double certScore = 0.0;
+    size_t R = ctx.job->requiredCerts.size();
+    ctx.certHits.assign(count * R, 0);
+    for (size_t j = 0; j < count; ++j) {
+        findPatterns(ctx.certMatcher, certs[j], ctx.found);
+        for (size_t r = 0; r < R; ++r) ctx.certHits[j * R + r] = ctx.found[r];
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t j = 0; j < count; ++j) {
+            if (ctx.certHits[j * R + r]) {
+                certScore += w.certs / (double)R;
+                if (matched) matched->push_back((uint32_t)j);
+            }
+        }
+    }
+    return certScore;
+}
+
+// no required certs: give some credit for any certification
+static inline double certAny(const ProfileWeights& w, size_t count)
+{
+    if (count == 0) return 0.0;
+    return min(w.certs, (double)count * 2.0);
+}
+
+static double certComponent(const ProfileWeights& w, const string_view* certs, size_t count, JobScorer& ctx, vector<uint32_t>* matched)
+{
+    if (ctx.job->requiredCerts.empty()) return certAny(w, count);
+    return certRequired(w, certs, count, ctx, matched);
+}
+
+// cert texts of a Candidate as views, in the scorer's scratch buffer
+static const string_view* candidateCerts(JobScorer& s, const Candidate& c)
+{
+    s.certViews.clear();
+    for (auto span : c.certifications) s.certViews.push_back(spanText(c, span));
+    return s.certViews.data();
+}
+
+static inline double clampScore(double score)
+{
+    if (score > 100.0) score = 100.0;
+    if (score < 0.0) score = 0.0;
+    return score;
+}
+
+static inline char gradeLetter(const ProfileWeights& w, double score)
+{
+    if (score >= w.gradeA) return 'A';
+    if (score >= w.gradeB) return 'B';
+    if (score >= w.gradeC) return 'C';
+    return 'D';
+}
+
+// ---- specialized kernels ----
+
+// which criteria a job sets; selects the kernel instantiation
+enum : unsigned {
+    JOB_HAS_SKILLS = 1,
+    JOB_HAS_MIN_EXPERIENCE = 2,
+    JOB_HAS_MIN_GPA = 4,
+    JOB_HAS_REQUIRED_CERTS = 8,
+    JOB_SHAPE_COUNT = 16
+};
+
+// one candidate's scoring inputs, wherever they are stored
+struct CandidateFields {
+    const uint32_t* skills;
+    size_t skillCount;
+    double years;
+    double gpa;
+    const string_view* certs;
+    size_t certCount;
+    double keywordRelevance;    // 0 .. 1
+};
+
+// Component by component the same calls, in the same order, as the generic helpers,
+// so every instantiation gives bit-identical scores to the batch path. The components
+// are also left in `parts`, for the sketch.
+template <class P, unsigned F>
+static inline double scoreFields(JobScorer& s, const CandidateFields& f, vector<uint32_t>* matchedSkills, vector<uint32_t>* matchedCerts, ScoreParts& parts)
+{
+    constexpr const ProfileWeights& w = P::weights;
+    const Job& job = *s.job;
+    double score = 0.0;
+
+    // Skills scoring
+    if constexpr ((F & JOB_HAS_SKILLS) != 0) {
+        size_t reqMatched = 0, prefMatched = 0;
+        countSkillMatches(f.skills, f.skillCount, job, reqMatched, prefMatched, matchedSkills);
+        parts.skills = skillsFromMatches(w, (double)reqMatched, (double)prefMatched, s.reqCount, s.prefCount);
+    }
+    else {
+        parts.skills = skillsDefault(w);
+    }
+    score += parts.skills;
+
+    // Experience scoring
+    if constexpr ((F & JOB_HAS_MIN_EXPERIENCE) != 0) parts.experience = experienceWithMin(w, f.years, job.minExperience);
+    else parts.experience = experienceScaled(w, f.years);
+    score += parts.experience;
+
+    // GPA scoring
+    if constexpr ((F & JOB_HAS_MIN_GPA) != 0) parts.gpa = gpaWithMin(w, f.gpa, job.minGPA);
+    else parts.gpa = gpaScaled(w, f.gpa);
+    score += parts.gpa;
+
+    // Certifications scoring
+    if constexpr ((F & JOB_HAS_REQUIRED_CERTS) != 0) parts.certs = certRequired(w, f.certs, f.certCount, s, matchedCerts);
+    else parts.certs = certAny(w, f.certCount);
+    score += parts.certs;
+
+    // Keywords/other
+    score += w.keywords * f.keywordRelevance;
+
+    // final clamp
+    parts.total = clampScore(score);
+    return parts.total;
+}
+
+// adds the candidate just scored (its components in s.parts) to s.sketch
+static void recordSketch(JobScorer& s, const CandidateFields& f)
+{
+    const vector<uint32_t>& required = s.sketch->requiredSkills;
+    s.hasRequired.assign(required.size(), 0);
+    for (size_t k = 0; k < f.skillCount; ++k) {
+        if (!hasSkill(s.job->requiredSkills, f.skills[k])) continue;
+        auto it = lower_bound(required.begin(), required.end(), f.skills[k]);
+        if (it != required.end() && *it == f.skills[k]) s.hasRequired[it - required.begin()] = 1;
+    }
+    updateSketch(*s.sketch, s.parts, s.hasRequired.data());
+}
+
+template <class P, unsigned F>
+static void scoreOneKernel(JobScorer& s, Candidate& c, double keywordRelevance)
+{
+    CandidateFields f;
+    f.skills = c.skills.data();
+    f.skillCount = c.skills.size();
+    f.years = (double)c.experienceYears;
+    f.gpa = c.gpa;
+    f.certs = candidateCerts(s, c);
+    f.certCount = c.certifications.size();
+    f.keywordRelevance = keywordRelevance;
+
+    c.matchedSkills.clear();
+    s.matchedCertIdx.clear();
+    c.score = scoreFields<P, F>(s, f, &c.matchedSkills, &s.matchedCertIdx, s.parts);
+    if (s.sketch) recordSketch(s, f);
+    c.grade = gradeLetter(P::weights, c.score);
+    c.matchedCerts.clear();
+    for (uint32_t k : s.matchedCertIdx) c.matchedCerts.push_back(c.certifications[k]);
+    RF_STAT_ADD((StatCounter)(STAT_GRADE_A + (c.grade - 'A')), 1);
+}
+
+// cert texts of pool entry i as views, in the scorer's scratch buffer
+static const string_view* poolCerts(JobScorer& s, const CandidatePool& p, size_t i)
+{
+    s.certViews.clear();
+    for (uint32_t k = p.certStart[i]; k < p.certStart[i + 1]; ++k) s.certViews.push_back(poolText(p, p.certs[k]));
+    return s.certViews.data();
+}
+
+// the cert texts are only looked at when the job requires certs
+template <unsigned F>
+static inline CandidateFields poolFields(JobScorer& s, const CandidatePool& p, const double* relevance, size_t i)
+{
+    CandidateFields f;
+    f.skills = p.skillIds.data() + p.skillStart[i];
+    f.skillCount = p.skillStart[i + 1] - p.skillStart[i];
+    f.years = (double)p.years[i];
+    f.gpa = p.gpa[i];
+    if constexpr ((F & JOB_HAS_REQUIRED_CERTS) != 0) f.certs = poolCerts(s, p, i);
+    else f.certs = nullptr;
+    f.certCount = p.certStart[i + 1] - p.certStart[i];
+    f.keywordRelevance = relevance ? relevance[i] : 0.0;
+    return f;
+}
+
+template <class P, unsigned F>
+static void scoreRangeKernel(JobScorer& s, const CandidatePool& p, const double* relevance, size_t begin, size_t end, ScoredRange& out)
+{
+    for (size_t i = begin; i < end; ++i) {
+        const CandidateFields f = poolFields<F>(s, p, relevance, i);
+        s.matchedCertIdx.clear();
+        const double score = scoreFields<P, F>(s, f, &out.matchedSkillIds, &s.matchedCertIdx, s.parts);
+        if (s.sketch) recordSketch(s, f);
+        out.matchedSkillStart.push_back((uint32_t)out.matchedSkillIds.size());
+        for (uint32_t k : s.matchedCertIdx) out.matchedCerts.push_back(p.certStart[i] + k);
+        out.matchedCertStart.push_back((uint32_t)out.matchedCerts.size());
+
+        const char grade = gradeLetter(P::weights, score);
+        out.score.push_back(score);
+        out.grade.push_back(grade);
+        RF_STAT_ADD((StatCounter)(STAT_GRADE_A + (grade - 'A')), 1);
+    }
+}
+
+// scores only: the pool is not written, so many threads can share it
+template <class P, unsigned F>
+static void scoreColumnKernel(JobScorer& s, const CandidatePool& p, const double* relevance, double* out)
+{
+    const size_t n = poolSize(p);
+    ScoreParts parts;
+    for (size_t i = 0; i < n; ++i) out[i] = scoreFields<P, F>(s, poolFields<F>(s, p, relevance, i), nullptr, nullptr, parts);
+}
+
+struct ScoringKernels {
+    void (*one)(JobScorer&, Candidate&, double);
+    void (*range)(JobScorer&, const CandidatePool&, const double*, size_t, size_t, ScoredRange&);
+    void (*column)(JobScorer&, const CandidatePool&, const double*, double*);
+};
+
+// every job shape of one profile, instantiated up front
+template <class P, size_t... F>
+static const ScoringKernels* kernelTable(index_sequence<F...>)
+{
+    static const ScoringKernels table[] = { { &scoreOneKernel<P, (unsigned)F>, &scoreRangeKernel<P, (unsigned)F>, &scoreColumnKernel<P, (unsigned)F> }... };
+    return table;
+}
+
+static ScoringKernels pickKernels(ScoringProfile profile, unsigned shape)
+{
+    const auto shapes = make_index_sequence<JOB_SHAPE_COUNT>();
+    switch (profile) {
+    case PROFILE_INTERN: return kernelTable<InternProfile>(shapes)[shape];
+    case PROFILE_MANAGEMENT: return kernelTable<ManagementProfile>(shapes)[shape];
+    default: return kernelTable<EngineeringProfile>(shapes)[shape];
+    }
+}
+
+void prepareScorer(JobScorer& s, const Job& job)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    s.job = &job;
+    s.weights = &profileWeights(job.profile);
+    s.reqCount = (int)skillSetSize(job.requiredSkills);
+    s.prefCount = (int)skillSetSize(job.preferredSkills);
+    buildMatcher(s.certMatcher, job.requiredCerts);
+    prepareKeywordQuery(s.keywords, job.keywords);
+
+    unsigned shape = 0;
+    if (s.reqCount + s.prefCount > 0) shape |= JOB_HAS_SKILLS;
+    if (job.minExperience > 0) shape |= JOB_HAS_MIN_EXPERIENCE;
+    if (job.minGPA > 0.0) shape |= JOB_HAS_MIN_GPA;
+    if (!job.requiredCerts.empty()) shape |= JOB_HAS_REQUIRED_CERTS;
+    ScoringKernels k = pickKernels(job.profile, shape);
+    s.scoreOne = k.one;
+    s.scoreRange = k.range;
+    s.scoreColumn = k.column;
+}
+
+void scoreCandidate(JobScorer& s, Candidate& c)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    s.scoreOne(s, c, scoreStandalone(s.keywords, resumeText(c)));
+}
+
+static void indexCandidates(TextIndex& index, const vector<Candidate>& candidates)
+{
+    RF_TIMED_SCOPE("index keywords");
+    for (auto& c : candidates) addDocument(index, resumeText(c));
+    finishTextIndex(index);
+}
+
+// Entries per parallel scoring chunk. A multiple of 64, so chunks of the score and
+// grade columns start on their own cache lines as far as the allocator allows.
+static const size_t SCORE_CHUNK = 4096;
+
+// one prepared scorer per worker: the scratch buffers in a JobScorer are not shared
+static vector<JobScorer> workerScorers(const Job& job, int threads)
+{
+    vector<JobScorer> scorers(max(threads, 1));
+    for (auto& s : scorers) prepareScorer(s, job);
+    return scorers;
+}
+
+void scoreAllCandidates(vector<Candidate>& candidates, const Job& job, int threads)
+{
+    RF_TIMED_SCOPE("score candidates");
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    TextIndex index;
+    indexCandidates(index, candidates);
+    vector<JobScorer> scorers = workerScorers(job, threads);
+    JobScorer& first = scorers[0];
+    bindKeywordQuery(first.keywords, index);
+    first.relevance.resize(candidates.size());
+    scoreAllDocuments(index, first.keywords, first.relevance.data());
+    const double* relevance = first.relevance.data();
+
+    // each chunk is a contiguous run of candidates, so threads share a line of
+    // candidate results at most where two chunks meet
+    const size_t n = candidates.size();
+    parallelFor((n + SCORE_CHUNK - 1) / SCORE_CHUNK, threads, [&](size_t chunk, int worker) {
+        RF_ALLOC_STAGE(ALLOC_SCORE);
+        JobScorer& s = scorers[worker];
+        const size_t end = min(n, (chunk + 1) * SCORE_CHUNK);
+        for (size_t i = chunk * SCORE_CHUNK; i < end; ++i) s.scoreOne(s, candidates[i], relevance[i]);
+    });
+}
+
+// keyword relevance of every entry, from the pool's index; null (no keyword points)
+// for a pool that was not indexed
+static const double* poolRelevance(JobScorer& s, const CandidatePool& p)
+{
+    if (documentCount(p.keywordIndex) != poolSize(p)) return nullptr;
+    bindKeywordQuery(s.keywords, p.keywordIndex);
+    s.relevance.resize(poolSize(p));
+    scoreAllDocuments(p.keywordIndex, s.keywords, s.relevance.data());
+    return s.relevance.data();
+}
+
+// appends starts[1 ..) to a start column, each plus base
+static void appendStarts(vector<uint32_t>& into, const vector<uint32_t>& starts, uint32_t base)
+{
+    for (size_t k = 1; k < starts.size(); ++k) into.push_back(starts[k] + base);
+}
+
+void scorePool(CandidatePool& p, const Job& job, int threads)
+{
+    RF_TIMED_SCOPE("score pool");
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    vector<JobScorer> scorers = workerScorers(job, threads);
+    const double* relevance = poolRelevance(scorers[0], p);
+    const size_t n = poolSize(p);
+    const size_t chunks = (n + SCORE_CHUNK - 1) / SCORE_CHUNK;
+    // a sketch per worker, added up at the end; the sum is the same however the
+    // chunks were shared out
+    vector<ScoreSketch> sketches(scorers.size());
+    for (size_t w = 0; w < scorers.size(); ++w) {
+        startSketch(sketches[w], job);
+        scorers[w].sketch = &sketches[w];
+    }
+    if (chunks <= 1 || threads <= 1) {
+        // one range: its buffers become the pool's columns as they are
+        ScoredRange r;
+        r.score.reserve(n);
+        r.grade.reserve(n);
+        r.matchedSkillStart.reserve(n + 1);
+        r.matchedCertStart.reserve(n + 1);
+        scorers[0].scoreRange(scorers[0], p, relevance, 0, n, r);
+        p.score = move(r.score);
+        p.grade = move(r.grade);
+        p.matchedSkillStart = move(r.matchedSkillStart);
+        p.matchedSkillIds = move(r.matchedSkillIds);
+        p.matchedCertStart = move(r.matchedCertStart);
+        p.matchedCerts = move(r.matchedCerts);
+        p.sketch = move(sketches[0]);
+        return;
+    }
+
+    vector<ScoredRange> ranges(chunks);
+    parallelFor(chunks, threads, [&](size_t chunk, int worker) {
+        RF_ALLOC_STAGE(ALLOC_SCORE);
+        const size_t begin = chunk * SCORE_CHUNK;
+        scorers[worker].scoreRange(scorers[worker], p, relevance, begin, min(n, begin + SCORE_CHUNK), ranges[chunk]);
+    });
+
+    // stitched in entry order, so the columns do not depend on which worker ran what
+    RF_TIMED_SCOPE("merge scored ranges");
+    p.score.clear();
+    p.grade.clear();
+    p.matchedSkillIds.clear();
+    p.matchedSkillStart.assign(1, 0);
+    p.matchedCerts.clear();
+    p.matchedCertStart.assign(1, 0);
+    p.score.reserve(n);
+    p.grade.reserve(n);
+    p.matchedSkillStart.reserve(n + 1);
+    p.matchedCertStart.reserve(n + 1);
+    for (auto& r : ranges) {
+        p.score.insert(p.score.end(), r.score.begin(), r.score.end());
+        p.grade.insert(p.grade.end(), r.grade.begin(), r.grade.end());
+        appendStarts(p.matchedSkillStart, r.matchedSkillStart, (uint32_t)p.matchedSkillIds.size());
+        p.matchedSkillIds.insert(p.matchedSkillIds.end(), r.matchedSkillIds.begin(), r.matchedSkillIds.end());
+        appendStarts(p.matchedCertStart, r.matchedCertStart, (uint32_t)p.matchedCerts.size());
+        p.matchedCerts.insert(p.matchedCerts.end(), r.matchedCerts.begin(), r.matchedCerts.end());
+        r = ScoredRange();
+    }
+    for (size_t w = 1; w < sketches.size(); ++w) mergeSketch(sketches[0], sketches[w]);
+    p.sketch = move(sketches[0]);
+}
+
+void scorePoolScores(JobScorer& s, const CandidatePool& p, double* out)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    s.scoreColumn(s, p, poolRelevance(s, p), out);
+}
+
+void scorePoolBest(JobScorer& s, const CandidatePool& p, size_t k, double* out)
+{
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    const size_t n = poolSize(p);
+    if (k == 0 || k >= n || documentCount(p.keywordIndex) != n) {
+        scorePoolScores(s, p, out);
+        return;
+    }
+    // picking the k-th bound is a pass over every entry; when the job's postings are
+    // not much longer than that, reading them all is cheaper
+    bindKeywordQuery(s.keywords, p.keywordIndex);
+    if (postingCount(p.keywordIndex, s.keywords) <= 4 * n) {
+        scorePoolScores(s, p, out);
+        return;
+    }
+    // without keyword relevance: exact when that is 0, otherwise a lower bound
+    s.scoreColumn(s, p, nullptr, out);
+    s.bounds.assign(out, out + n);
+    nth_element(s.bounds.begin(), s.bounds.begin() + (k - 1), s.bounds.end(), greater<double>());
+    const double kth = s.bounds[k - 1];     // the k-th best final score is at least this
+
+    const double maxKeywords = s.weights->keywords;
+    s.entries.clear();
+    for (uint32_t i = 0; i < (uint32_t)n; ++i) {
+        if (out[i] + maxKeywords >= kth) s.entries.push_back(i);
+    }
+    s.relevance.resize(s.entries.size());
+    scoreDocuments(p.keywordIndex, s.keywords, s.entries.data(), s.entries.size(), s.relevance.data());
+    // same sum, in the same order, as the kernels; an entry already at 100 stays there
+    for (size_t j = 0; j < s.entries.size(); ++j) out[s.entries[j]] = clampScore(out[s.entries[j]] + maxKeywords * s.relevance[j]);
+}
+
+// ---- batch scoring: many jobs against one columnar copy of the candidate pool ----
+
+// numeric candidate fields laid out contiguously for the SIMD kernels
+struct CandidateColumns {
+    vector<double> years;
+    vector<double> gpa;
+};
+
+// per-job inputs the kernels cannot compute themselves (bitset lookups, text matching)
+struct JobRow {
+    vector<double> reqMatched;
+    vector<double> prefMatched;
+    vector<double> cert;
+    vector<double> keyword;
+};
+
+// Scores one job row: skills, experience and GPA are computed here from the columns;
+// cert and keyword components come precomputed. Every lane performs the same IEEE
+// operations in the same order as the scalar helpers, so results are bit-identical to
+// scoreAllCandidates (as long as the compiler is not allowed to fuse multiply-adds).
+static void scoreRowKernel(const ProfileWeights& w, const Job& job, int reqCount, int prefCount, const CandidateColumns& cols, const JobRow& row, double* out)
+{
+    const size_t n = cols.years.size();
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d hundred = _mm256_set1_pd(100.0);
+    const __m256d expW = _mm256_set1_pd(w.experience);
+    const __m256d gpaW = _mm256_set1_pd(w.gpa);
+    const __m256d expCap = _mm256_set1_pd(w.maxExperience);
+    const __m256d minExp = _mm256_set1_pd((double)job.minExperience);
+    const __m256d minGPA = _mm256_set1_pd(job.minGPA);
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d reqPart = _mm256_set1_pd(w.skills * w.requiredShare);
+    const __m256d prefPart = _mm256_set1_pd(w.skills * w.preferredShare);
+    const __m256d reqDen = _mm256_set1_pd((double)reqCount);
+    const __m256d prefDen = _mm256_set1_pd((double)prefCount);
+    const __m256d noSkills = _mm256_set1_pd(skillsDefault(w));
+
+    for (; i + 4 <= n; i += 4) {
+        // skills
+        __m256d skills = noSkills;
+        if (reqCount + prefCount > 0) {
+            skills = zero;
+            if (reqCount > 0) skills = _mm256_add_pd(skills, _mm256_mul_pd(reqPart, _mm256_div_pd(_mm256_loadu_pd(&row.reqMatched[i]), reqDen)));
+            if (prefCount > 0) skills = _mm256_add_pd(skills, _mm256_mul_pd(prefPart, _mm256_div_pd(_mm256_loadu_pd(&row.prefMatched[i]), prefDen)));
+        }
+
+        // experience: 0 unless years > 0
+        __m256d years = _mm256_loadu_pd(&cols.years[i]);
+        __m256d exp;
+        if (job.minExperience > 0) {
+            __m256d part = _mm256_mul_pd(expW, _mm256_div_pd(years, minExp));
+            exp = _mm256_blendv_pd(part, expW, _mm256_cmp_pd(years, minExp, _CMP_GE_OQ));
+        }
+        else {
+            exp = _mm256_mul_pd(expW, _mm256_div_pd(_mm256_min_pd(years, expCap), expCap));
+        }
+        exp = _mm256_and_pd(exp, _mm256_cmp_pd(years, zero, _CMP_GT_OQ));
+
+        // GPA: 0 unless gpa > 0
+        __m256d g = _mm256_loadu_pd(&cols.gpa[i]);
+        __m256d gpa;
+        if (job.minGPA > 0.0) {
+            __m256d ratio = _mm256_max_pd(zero, _mm256_min_pd(one, _mm256_div_pd(g, minGPA)));
+            gpa = _mm256_blendv_pd(_mm256_mul_pd(gpaW, ratio), gpaW, _mm256_cmp_pd(g, minGPA, _CMP_GE_OQ));
+        }
+        else {
+            gpa = _mm256_mul_pd(gpaW, _mm256_min_pd(_mm256_div_pd(g, four), one));
+        }
+        gpa = _mm256_and_pd(gpa, _mm256_cmp_pd(g, zero, _CMP_GT_OQ));
+
+        __m256d score = _mm256_add_pd(skills, exp);
+        score = _mm256_add_pd(score, gpa);
+        score = _mm256_add_pd(score, _mm256_loadu_pd(&row.cert[i]));
+        score = _mm256_add_pd(score, _mm256_loadu_pd(&row.keyword[i]));
+        score = _mm256_max_pd(_mm256_min_pd(score, hundred), zero);
+        _mm256_storeu_pd(out + i, score);
+    }
+#endif
+    // scalar fallback and tail
+    for (; i < n; ++i) {
+        double score = skillsFromCounts(w, row.reqMatched[i], row.prefMatched[i], reqCount, prefCount);
+        score += experienceComponent(w, cols.years[i], job.minExperience);
+        score += gpaComponent(w, cols.gpa[i], job.minGPA);
+        score += row.cert[i];
+        score += row.keyword[i];
+        out[i] = clampScore(score);
+    }
+}
+
+ScoreMatrix scoreJobsBatch(const vector<Candidate>& candidates, const vector<Job>& jobs)
+{
+    RF_TIMED_SCOPE("score batch");
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    const size_t n = candidates.size();
+    ScoreMatrix m;
+    m.jobCount = jobs.size();
+    m.candidateCount = n;
+    m.scores.assign(jobs.size() * n, 0.0);
+
+    CandidateColumns cols;
+    cols.years.resize(n);
+    cols.gpa.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        cols.years[i] = (double)candidates[i].experienceYears;
+        cols.gpa[i] = candidates[i].gpa;
+    }
+
+    TextIndex index;
+    indexCandidates(index, candidates);
+    vector<double> relevance(n);
+
+    JobRow row;
+    row.reqMatched.resize(n);
+    row.prefMatched.resize(n);
+    row.cert.resize(n);
+    row.keyword.resize(n);
+    JobScorer scorer;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const Job& job = jobs[j];
+        prepareScorer(scorer, job);
+        const int reqCount = scorer.reqCount;
+        const int prefCount = scorer.prefCount;
+        const ProfileWeights& w = *scorer.weights;
+        bindKeywordQuery(scorer.keywords, index);
+        scoreAllDocuments(index, scorer.keywords, relevance.data());
+        for (size_t i = 0; i < n; ++i) {
+            size_t req = 0, pref = 0;
+            const Candidate& c = candidates[i];
+            if (reqCount + prefCount > 0) countSkillMatches(c.skills.data(), c.skills.size(), job, req, pref, nullptr);
+            row.reqMatched[i] = (double)req;
+            row.prefMatched[i] = (double)pref;
+            row.cert[i] = certComponent(w, candidateCerts(scorer, c), c.certifications.size(), scorer, nullptr);
+            row.keyword[i] = w.keywords * relevance[i];
+        }
+        scoreRowKernel(w, job, reqCount, prefCount, cols, row, &m.scores[j * n]);
+    }
+    return m;
+}
+
+double gradeFromScore(double score)
+{
+    return score; // placeholder: scores are numeric; grading done by letterFromScore
+}
+
+char letterFromScore(double score)
+{
+    return gradeLetter(EngineeringProfile::weights, score);
+}
+
+char letterFromScore(double score, ScoringProfile profile)
+{
+    return gradeLetter(profileWeights(profile), score);
 }
\ No newline at end of file
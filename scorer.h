@@ -1,14 +1,98 @@
-#ifndef SCORER_H
-#define SCORER_H
-
-#include "parser.h"
-#include <vector>
-#include <string>
-
-using namespace std;
-
-void scoreAllCandidates(vector<Candidate>& candidates, const Job& job);
-double gradeFromScore(double score); // returns numeric bucket boundaries but we store grade char in candidate
-char letterFromScore(double score);
-
-#endif // SCORER_H#pragma once
+#ifndef SCORER_H
+#define SCORER_H
+
+#include "parser.h"
+#include "matcher.h"
+#include "candidatepool.h"
+#include "sketch.h"
+#include "textindex.h"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// With threads > 1 the candidates are split into chunks scored on a work-stealing pool
+// (threadpool.h); every candidate gets the same result for any thread count.
+void scoreAllCandidates(vector<Candidate>& candidates, const Job& job, int threads = 1);
+
+// scorePool's results for a range of pool entries, kept apart from the pool until the
+// range is done so threads scoring neighbouring ranges never write to shared lines
+struct ScoredRange {
+    vector<double> score;
+    vector<char> grade;
+    vector<uint32_t> matchedSkillStart = { 0 };     // relative to this range
+    vector<uint32_t> matchedSkillIds;
+    vector<uint32_t> matchedCertStart = { 0 };
+    vector<uint32_t> matchedCerts;
+};
+
+// Per-job scoring state (kernel, skill counts, compiled required-cert matcher, scratch).
+// Prepare once per job and reuse it for every candidate; one per thread. Weights and
+// grade thresholds come from job.profile (profiles.h).
+//
+// The keyword component is the BM25 relevance (textindex.h) of the resume text to the
+// job's keywords, times the profile's keyword weight. Kernels take the relevance as an
+// input (null = 0 for every candidate): the pool paths look it up in the pool's index,
+// reading only the postings of the job's words.
+struct JobScorer {
+    const Job* job = nullptr;
+    const ProfileWeights* weights = nullptr;   // job.profile's weights
+    void (*scoreOne)(JobScorer&, Candidate&, double) = nullptr;     // kernels for this job's profile and criteria
+    void (*scoreRange)(JobScorer&, const CandidatePool&, const double*, size_t, size_t, ScoredRange&) = nullptr;
+    void (*scoreColumn)(JobScorer&, const CandidatePool&, const double*, double*) = nullptr;
+    int reqCount = 0;
+    int prefCount = 0;
+    PatternMatcher certMatcher;
+    KeywordQuery keywords;
+    vector<uint8_t> found, certHits;
+    vector<string_view> certViews;
+    vector<uint32_t> matchedCertIdx;
+    vector<double> relevance, bounds;
+    vector<uint32_t> entries;
+    // When set, every candidate scored through scoreCandidate or scorePool is added
+    // to it; parts / hasRequired then hold the last one's components and required
+    // skills (what --watch needs to take it back out later).
+    ScoreSketch* sketch = nullptr;
+    ScoreParts parts;
+    vector<uint8_t> hasRequired;
+};
+
+void prepareScorer(JobScorer& s, const Job& job);
+// Scores one candidate on its own. With no other resumes to weigh the job's words
+// against, keyword relevance falls back to scoreStandalone, so the keyword component
+// (only that) can differ from scoreAllCandidates.
+void scoreCandidate(JobScorer& s, Candidate& c);
+// Scores every pool entry into its score / grade / matched columns; same results as
+// scoreAllCandidates on the equivalent candidates. With threads > 1 chunks of entries
+// are scored in parallel into ScoredRanges, then copied into the columns in entry
+// order, so the columns are the same for any thread count. The pool's sketch is
+// rebuilt along the way.
+void scorePool(CandidatePool& pool, const Job& job, int threads = 1);
+// Scores every pool entry into out[0 .. poolSize) without writing to the pool, so any
+// number of threads can score one shared pool (each with its own prepared scorer).
+void scorePoolScores(JobScorer& s, const CandidatePool& pool, double* out);
+// Like scorePoolScores when only the best k entries matter. The keyword component can
+// add at most the profile's keyword weight, so every other component is scored first
+// and only the entries that could still reach the k-th best score are looked up in the
+// keyword postings. Those, and so the best k, get exact scores; the rest keep a lower
+// bound that is below the k-th best.
+void scorePoolBest(JobScorer& s, const CandidatePool& pool, size_t k, double* out);
+
+// jobs x candidates scores, row-major: scores[j * candidateCount + i]
+struct ScoreMatrix {
+    size_t jobCount = 0;
+    size_t candidateCount = 0;
+    vector<double> scores;
+};
+
+// Scores every job against every candidate without touching the candidates' result
+// fields. Gives the same numbers as scoreAllCandidates job by job (the keyword index is
+// built once for all jobs); the experience,
+// GPA and skill arithmetic runs on AVX2 over columnar candidate data when the build
+// enables it (/arch:AVX2, -mavx2), with a scalar fallback otherwise.
+ScoreMatrix scoreJobsBatch(const vector<Candidate>& candidates, const vector<Job>& jobs);
+double gradeFromScore(double score); // returns numeric bucket boundaries but we store grade char in candidate
+char letterFromScore(double score);     // engineering thresholds
+char letterFromScore(double score, ScoringProfile profile);
+
+#endif // SCORER_H#pragma once
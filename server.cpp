@@ -0,0 +1,387 @@
+#include "server.h"
+#include "candidatepool.h"
+#include "dedupe.h"
+#include "ranking.h"
+#include "scorer.h"
+#include "stats.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+int runServer(const ServerOptions&)
+{
+    cout << "--serve needs Unix domain sockets and is not supported on Windows\n";
+    return 1;
+}
+
+#else
+
+// the pool queries are answered from; replaced as a whole on reload
+struct ServedPool {
+    CandidatePool pool;
+    uint64_t fingerprint = 0;   // folderFingerprint() taken before parsing
+    uint64_t generation = 0;    // 1 for the first load, +1 per reload
+};
+
+static const size_t LATENCY_WINDOW = 1024;      // queries the percentiles are taken over
+static const size_t MAX_REQUEST_BYTES = 1 << 20;
+static const int CLIENT_TIMEOUT_SECONDS = 10;   // per read / write on a connection
+
+// latencies of the most recent queries
+struct LatencyWindow {
+    mutex m;
+    vector<double> ms;
+    size_t next = 0;            // ring position once ms is full
+    uint64_t queries = 0;
+};
+
+// connections accepted but not yet picked up by a worker
+struct ConnectionQueue {
+    mutex m;
+    condition_variable ready;
+    deque<int> fds;
+    bool closed = false;
+};
+
+struct ServerState {
+    const ServerOptions* options = nullptr;
+    shared_ptr<const ServedPool> current;   // only touched through atomic_load / atomic_store
+    LatencyWindow latency;
+    ConnectionQueue queue;
+    atomic<bool> stopping{ false };
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+static shared_ptr<const ServedPool> loadPool(const ServerOptions& o, uint64_t generation)
+{
+    RF_TIMED_SCOPE("load pool");
+    auto served = make_shared<ServedPool>();
+    // taken first: a file changed while parsing shows up again on the next check
+    served->fingerprint = folderFingerprint(o.resumesFolder);
+    vector<Candidate> candidates = parseResumesFromFolder(o.resumesFolder, o.ingest);
+    DedupeResult dedupe;
+    if (o.dedupe) dedupe = findNearDuplicates(candidates, o.ingest.threads, o.dedupeThreshold);
+    served->pool = poolFromCandidates(move(candidates), o.dedupe ? &dedupe.representative : nullptr);
+    served->generation = generation;
+    return served;
+}
+
+// nearest-rank percentile; v is reordered
+static double percentile(vector<double>& v, double p)
+{
+    if (v.empty()) return 0.0;
+    size_t rank = (size_t)ceil(p * (double)v.size());
+    size_t k = rank == 0 ? 0 : rank - 1;
+    nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void recordLatency(LatencyWindow& w, double ms, double& p50, double& p99, uint64_t& queries)
+{
+    vector<double> recent;
+    {
+        lock_guard<mutex> lock(w.m);
+        if (w.ms.size() < LATENCY_WINDOW) w.ms.push_back(ms);
+        else w.ms[w.next] = ms;
+        w.next = (w.next + 1) % LATENCY_WINDOW;
+        queries = ++w.queries;
+        recent = w.ms;
+    }
+    p50 = percentile(recent, 0.50);
+    p99 = percentile(recent, 0.99);
+}
+
+static void appendNumber(string& out, const char* format, double v)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), format, v);
+    out += buf;
+}
+
+static string errorReply(const char* message)
+{
+    string out = "{\"ok\":false,\"error\":";
+    appendJsonString(out, message);
+    out += "}\n";
+    return out;
+}
+
+// scores the job text against the current pool and builds the JSON reply
+static string handleQuery(ServerState& st, string_view jobText)
+{
+    RF_TIMED_SCOPE("serve query");
+    const auto start = chrono::steady_clock::now();
+    const ServerOptions& o = *st.options;
+    if (trimView(jobText).empty()) return errorReply("empty job description");
+
+    // holds this generation alive until the reply is built, whatever reloads meanwhile
+    const shared_ptr<const ServedPool> served = atomic_load(&st.current);
+    const CandidatePool& pool = served->pool;
+
+    Job job = parseJobText(jobText);
+    if (o.profileSet) job.profile = o.profile;
+    JobScorer scorer;
+    prepareScorer(scorer, job);
+
+    static thread_local vector<double> scores;
+    scores.resize(poolSize(pool));
+    scorePoolBest(scorer, pool, o.top, scores.data());
+    const vector<size_t> best = topPoolEntries(pool, scores.data(), o.top);
+
+    string out = "{\"ok\":true,\"profile\":";
+    appendJsonString(out, profileWeights(job.profile).name);
+    out += ",\"pool_size\":" + to_string(poolSize(pool));
+    out += ",\"generation\":" + to_string(served->generation);
+    out += ",\"results\":[";
+    for (size_t r = 0; r < best.size(); ++r) {
+        // only the returned few are rescored for their matched skills and certs; the
+        // pool entry has no resume text left, so the score is the pool's
+        Candidate c = candidateFromPool(pool, best[r]);
+        scoreCandidate(scorer, c);
+        c.score = scores[best[r]];
+        c.grade = letterFromScore(c.score, job.profile);
+        if (r > 0) out += ',';
+        out += "{\"rank\":" + to_string(r + 1) + ",\"name\":";
+        appendJsonString(out, spanText(c, c.name));
+        out += ",\"file\":";
+        appendJsonString(out, spanText(c, c.filepath));
+        out += ",\"score\":";
+        appendNumber(out, "%.2f", c.score);
+        out += ",\"grade\":\"";
+        out += c.grade;
+        out += "\",\"matched_skills\":[";
+        for (size_t k = 0; k < c.matchedSkills.size(); ++k) {
+            if (k > 0) out += ',';
+            appendJsonString(out, skillName(c.matchedSkills[k]));
+        }
+        out += "],\"matched_certifications\":[";
+        for (size_t k = 0; k < c.matchedCerts.size(); ++k) {
+            if (k > 0) out += ',';
+            appendJsonString(out, spanText(c, c.matchedCerts[k]));
+        }
+        out += ']';
+        const uint32_t i = (uint32_t)best[r];
+        if (pool.duplicateStart[i] != pool.duplicateStart[i + 1]) {
+            out += ",\"duplicates\":[";
+            for (uint32_t k = pool.duplicateStart[i]; k < pool.duplicateStart[i + 1]; ++k) {
+                if (k > pool.duplicateStart[i]) out += ',';
+                appendJsonString(out, poolText(pool, pool.duplicates[k]));
+            }
+            out += ']';
+        }
+        out += '}';
+    }
+    out += ']';
+
+    const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    double p50 = 0.0, p99 = 0.0;
+    uint64_t queries = 0;
+    recordLatency(st.latency, ms, p50, p99, queries);
+    out += ",\"latency_ms\":";
+    appendNumber(out, "%.3f", ms);
+    out += ",\"p50_ms\":";
+    appendNumber(out, "%.3f", p50);
+    out += ",\"p99_ms\":";
+    appendNumber(out, "%.3f", p99);
+    out += ",\"queries\":" + to_string(queries) + "}\n";
+    return out;
+}
+
+// everything the client writes until it shuts down its side; false on error, timeout
+// or an oversized request
+static bool readRequest(int fd, string& out)
+{
+    char buf[16384];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n == 0) return true;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (out.size() + (size_t)n > MAX_REQUEST_BYTES) return false;
+        out.append(buf, (size_t)n);
+    }
+}
+
+static void writeAll(int fd, const string& data)
+{
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = send(fd, data.data() + done, data.size() - done, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;     // client went away; nothing to report to
+        done += (size_t)n;
+    }
+}
+
+static void serveConnections(ServerState& st)
+{
+    ConnectionQueue& q = st.queue;
+    for (;;) {
+        int fd = -1;
+        {
+            unique_lock<mutex> lock(q.m);
+            q.ready.wait(lock, [&] { return q.closed || !q.fds.empty(); });
+            if (q.fds.empty()) return;
+            fd = q.fds.front();
+            q.fds.pop_front();
+        }
+        string request, reply;
+        if (!readRequest(fd, request)) {
+            reply = errorReply("request too large or not finished in time");
+        }
+        else {
+            try {
+                reply = handleQuery(st, request);
+            }
+            catch (const std::exception& e) {
+                reply = errorReply(e.what());
+            }
+        }
+        writeAll(fd, reply);
+        close(fd);
+    }
+}
+
+// re-parses the folder whenever its fingerprint changes and swaps the new pool in
+static void watchFolder(ServerState& st)
+{
+    const ServerOptions& o = *st.options;
+    auto lastCheck = chrono::steady_clock::now();
+    while (!st.stopping) {
+        this_thread::sleep_for(chrono::milliseconds(200));
+        if (chrono::steady_clock::now() - lastCheck < chrono::seconds(o.reloadSeconds)) continue;
+        lastCheck = chrono::steady_clock::now();
+
+        const shared_ptr<const ServedPool> old = atomic_load(&st.current);
+        if (folderFingerprint(o.resumesFolder) == old->fingerprint) continue;
+        try {
+            shared_ptr<const ServedPool> next = loadPool(o, old->generation + 1);
+            atomic_store(&st.current, next);
+            cout << "Reloaded " << poolSize(next->pool) << " candidates (generation " << next->generation << ")" << endl;
+        }
+        catch (const std::exception& e) {
+            cout << "Reload failed, still serving generation " << old->generation << ": " << e.what() << endl;
+        }
+    }
+}
+
+static int openSocket(const string& path)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        cout << "Invalid socket path (at most " << sizeof(addr.sun_path) - 1 << " bytes): " << path << "\n";
+        return -1;
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    // a socket left behind by a previous run would make bind fail; other files are kept
+    struct stat sb;
+    if (lstat(path.c_str(), &sb) == 0 && S_ISSOCK(sb.st_mode)) unlink(path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (const sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        cout << "Cannot listen on " << path << ": " << strerror(errno) << "\n";
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int runServer(const ServerOptions& o)
+{
+    ServerState st;
+    st.options = &o;
+    st.current = loadPool(o, 1);
+    if (poolSize(st.current->pool) == 0) {
+        cout << "No resumes found in folder yet: " << o.resumesFolder << "\n";
+    }
+
+    const int listenFd = openSocket(o.socketPath);
+    if (listenFd < 0) return 1;
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+
+    const int workers = max(1, o.ingest.threads);
+    cout << "Serving " << poolSize(st.current->pool) << " candidates on " << o.socketPath
+        << " with " << workers << " worker(s)" << endl;
+
+    vector<thread> pool;
+    for (int w = 0; w < workers; ++w) pool.emplace_back(serveConnections, ref(st));
+    thread reloader;
+    if (o.reloadSeconds > 0) reloader = thread(watchFolder, ref(st));
+
+    // the timeout lets a stop signal through even when no client connects
+    while (!stopRequested) {
+        pollfd p;
+        p.fd = listenFd;
+        p.events = POLLIN;
+        p.revents = 0;
+        if (poll(&p, 1, 250) <= 0) continue;
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+        timeval tv;
+        tv.tv_sec = CLIENT_TIMEOUT_SECONDS;
+        tv.tv_usec = 0;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        {
+            lock_guard<mutex> lock(st.queue.m);
+            st.queue.fds.push_back(fd);
+        }
+        st.queue.ready.notify_one();
+    }
+
+    // stop accepting, answer what is already queued, then shut down
+    st.stopping = true;
+    close(listenFd);
+    unlink(o.socketPath.c_str());
+    {
+        lock_guard<mutex> lock(st.queue.m);
+        st.queue.closed = true;
+    }
+    st.queue.ready.notify_all();
+    for (auto& t : pool) t.join();
+    if (reloader.joinable()) reloader.join();
+    cout << "Server stopped after " << st.latency.queries << " queries" << endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "parser.h"
+#include <cstddef>
+#include <string>
+
+using namespace std;
+
+struct ServerOptions {
+    string socketPath;          // Unix domain socket to listen on
+    string resumesFolder;
+    IngestOptions ingest;       // threads also sets the number of query workers
+    size_t top = 20;            // results returned per query
+    int reloadSeconds = 5;      // how often to check the folder for changes, 0 = never
+    bool dedupe = false;        // fold near-duplicate resumes into one entry (dedupe.h)
+    double dedupeThreshold = 0.8;
+    bool profileSet = false;    // score every query with `profile`, whatever it says
+    ScoringProfile profile = PROFILE_ENGINEERING;
+};
+
+// Resident scoring daemon. Parses the resume folder once into a CandidatePool and
+// answers job queries on a Unix domain socket until SIGINT / SIGTERM.
+//
+// A client connects, writes a job description in the parseJobDescription format and
+// shuts down its write side; the server replies with one JSON object (the best
+// `top` candidates with score, grade and matched skills / certifications, plus the
+// query's latency and the p50 / p99 over recent queries) and closes the connection.
+// Queries run on a fixed set of worker threads, all reading the same pool. When the
+// folder's files change the pool is re-parsed in the background and swapped in
+// atomically: queries already running finish on the pool they started with.
+// Returns the process exit code. Not available on Windows.
+int runServer(const ServerOptions& options);
+
+#endif // SERVER_H
@@ -0,0 +1,204 @@
+#include "shard.h"
+#include "mappedfile.h"
+#include "snapshot.h"
+#include "stats.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <spawn.h>
+#include <sys/wait.h>
+#endif
+
+using namespace std;
+
+#ifndef _WIN32
+extern char** environ;
+#endif
+
+/*
+ Layout (host byte order, like snapshots):
+   ShardHeader
+   score sketch (sketch.h), sketchSize bytes
+   snapshot of ShardResult::best (snapshot.h), to the end of the file
+*/
+
+static const char SHARD_MAGIC[8] = { 'R', 'F', 'S', 'H', 'A', 'R', 'D', '\0' };
+static const uint32_t SHARD_VERSION = 2;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct ShardHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t shard;
+    uint32_t shardCount;
+    uint64_t total;
+    uint64_t byGrade[4];
+    uint64_t sketchSize;
+};
+
+bool writeShardResult(const string& path, const ShardResult& r)
+{
+    RF_TIMED_SCOPE("write shard");
+    ShardHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SHARD_MAGIC, sizeof(h.magic));
+    h.version = SHARD_VERSION;
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.shard = r.shard;
+    h.shardCount = r.shardCount;
+    h.total = r.counts.total;
+    for (int g = 0; g < 4; ++g) h.byGrade[g] = r.counts.byGrade[g];
+    ostringstream sketch;
+    writeSketch(sketch, r.sketch);
+    const string sketchBytes = sketch.str();
+    h.sketchSize = sketchBytes.size();
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Cannot write shard result: " << path << "\n";
+        return false;
+    }
+    out.write((const char*)&h, sizeof(h));
+    out.write(sketchBytes.data(), (streamsize)sketchBytes.size());
+    bool ok = writeSnapshot(out, r.best);
+    out.close();
+    if (!ok || !out) {
+        cout << "Failed writing shard result: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool readShardResult(const string& path, ShardResult& r)
+{
+    RF_TIMED_SCOPE("read shard");
+    MappedFile f;
+    if (!mapFile(f, path)) {
+        cout << "Cannot open shard result: " << path << "\n";
+        return false;
+    }
+    ShardHeader h;
+    if (f.size < sizeof(h)) {
+        cout << "Not a shard result: " << path << "\n";
+        return false;
+    }
+    memcpy(&h, f.data, sizeof(h));
+    if (memcmp(h.magic, SHARD_MAGIC, sizeof(h.magic)) != 0 || h.byteOrder != BYTE_ORDER_MARK) {
+        cout << "Not a shard result: " << path << "\n";
+        return false;
+    }
+    if (h.version != SHARD_VERSION) {
+        cout << "Unsupported shard result version " << h.version << " in " << path << "\n";
+        return false;
+    }
+    size_t sketchSize = 0;
+    ShardResult result;
+    if (h.shardCount == 0 || h.shard >= h.shardCount || h.sketchSize > f.size - sizeof(h)
+        || !readSketch(f.data + sizeof(h), (size_t)h.sketchSize, result.sketch, &sketchSize) || sketchSize != h.sketchSize) {
+        cout << "Corrupt shard result: " << path << "\n";
+        return false;
+    }
+
+    const size_t snapshotStart = sizeof(h) + sketchSize;
+    if (!readSnapshot(f.data + snapshotStart, f.size - snapshotStart, path, result.best)) return false;
+    result.shard = h.shard;
+    result.shardCount = h.shardCount;
+    result.counts.total = (size_t)h.total;
+    for (int g = 0; g < 4; ++g) result.counts.byGrade[g] = (size_t)h.byGrade[g];
+    r = move(result);
+    return true;
+}
+
+#ifdef _WIN32
+
+// _spawnvp joins the arguments into one command line, so each needs quoting
+static string quoteArgument(const string& arg)
+{
+    if (!arg.empty() && arg.find_first_of(" \t\"") == string::npos) return arg;
+    string out = "\"";
+    size_t slashes = 0;
+    for (char ch : arg) {
+        if (ch == '\\') {
+            slashes++;
+            continue;
+        }
+        // backslashes before a quote are escaped, elsewhere they are literal
+        out.append(ch == '"' ? slashes * 2 + 1 : slashes, '\\');
+        slashes = 0;
+        out += ch;
+    }
+    out.append(slashes * 2, '\\');
+    out += '"';
+    return out;
+}
+
+bool runProcesses(const vector<vector<string>>& commands)
+{
+    vector<intptr_t> handles;
+    bool ok = true;
+    cout.flush();   // the children write to the same console
+    for (auto& cmd : commands) {
+        vector<string> quoted;
+        for (auto& a : cmd) quoted.push_back(quoteArgument(a));
+        vector<const char*> argv;
+        for (auto& a : quoted) argv.push_back(a.c_str());
+        argv.push_back(nullptr);
+        intptr_t h = _spawnvp(_P_NOWAIT, cmd[0].c_str(), argv.data());
+        if (h == -1) {
+            cout << "Cannot start " << cmd[0] << "\n";
+            ok = false;
+            break;
+        }
+        handles.push_back(h);
+    }
+    for (intptr_t h : handles) {
+        int status = 0;
+        if (_cwait(&status, h, _WAIT_CHILD) == -1 || status != 0) ok = false;
+    }
+    return ok;
+}
+
+#else
+
+bool runProcesses(const vector<vector<string>>& commands)
+{
+    vector<pid_t> children;
+    bool ok = true;
+    cout.flush();   // the children write to the same console
+    for (auto& cmd : commands) {
+        vector<char*> argv;
+        for (auto& a : cmd) argv.push_back(const_cast<char*>(a.c_str()));
+        argv.push_back(nullptr);
+        pid_t pid;
+        int rc = posix_spawnp(&pid, cmd[0].c_str(), nullptr, nullptr, argv.data(), environ);
+        if (rc != 0) {
+            cout << "Cannot start " << cmd[0] << ": " << strerror(rc) << "\n";
+            ok = false;
+            break;
+        }
+        children.push_back(pid);
+    }
+    // every started child is waited for, even after a failure, so none is left behind
+    for (pid_t pid : children) {
+        int status = 0;
+        while (waitpid(pid, &status, 0) == -1) {
+            if (errno != EINTR) {
+                ok = false;
+                break;
+            }
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+    }
+    return ok;
+}
+
+#endif
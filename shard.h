@@ -0,0 +1,38 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "parser.h"
+#include "ranking.h"
+#include "sketch.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Sharded scoring for pools too big for one process. The resume folder is split into
+// shardCount shards by shardOfFile (parser.h), so every process agrees on the split
+// without talking to the others. A worker streams one shard through a top-k and
+// writes the result to a shard file; the coordinator merges the files into the final
+// ranking. Workers need nothing but the folder, the job file and their shard number,
+// so they can run anywhere the files are visible.
+struct ShardResult {
+    uint32_t shard = 0;
+    uint32_t shardCount = 1;
+    GradeCounts counts;         // over every resume in the shard
+    ScoreSketch sketch;         // likewise
+    vector<Candidate> best;     // the shard's top k, best first
+};
+
+// A fixed header (shard number, grade counts), the sketch, then the candidates as a
+// snapshot (snapshot.h). Only parse results are stored: the coordinator rescores the
+// few candidates it receives to recover scores and matches.
+bool writeShardResult(const string& path, const ShardResult& r);
+bool readShardResult(const string& path, ShardResult& r);
+
+// Starts every command as a child process (command[0] is looked up on PATH like a
+// shell would), then waits for all of them. False if one could not be started or
+// exited with a failure code.
+bool runProcesses(const vector<vector<string>>& commands);
+
+#endif // SHARD_H
@@ -0,0 +1,193 @@
+#include "sketch.h"
+#include "profiles.h"
+#include "skilldict.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+using namespace std;
+
+/*
+ Binary layout (host byte order, like snapshots and shard results):
+   uint64 count, uint64 scoreSumMicros, uint64 scoreBins[SCORE_BINS]
+   per component (skills, experience, GPA, certs):
+     double max, uint64 bins[COMPONENT_BINS], uint64 sumMicros
+   uint32 required skill count, then per skill:
+     uint32 name length, the name, uint64 missing
+*/
+
+static inline uint64_t toMicros(double points)
+{
+    return (uint64_t)llround(max(points, 0.0) * 1e6);
+}
+
+static void startComponent(ComponentHistogram& h, double range)
+{
+    h = ComponentHistogram();
+    h.max = range;
+}
+
+void startSketch(ScoreSketch& s, const Job& job)
+{
+    const ProfileWeights& w = profileWeights(job.profile);
+    s = ScoreSketch();
+    startComponent(s.skills, w.skills);
+    startComponent(s.experience, w.experience);
+    startComponent(s.gpa, w.gpa);
+    startComponent(s.certs, w.certs);
+    const uint32_t ids = (uint32_t)job.requiredSkills.bits.size() * 64;
+    for (uint32_t id = 0; id < ids; ++id) {
+        if (hasSkill(job.requiredSkills, id)) s.requiredSkills.push_back(id);
+    }
+    s.missing.assign(s.requiredSkills.size(), 0);
+}
+
+static void addComponent(ComponentHistogram& h, double value, int sign)
+{
+    size_t bin = 0;
+    if (h.max > 0.0 && value > 0.0) bin = min(COMPONENT_BINS - 1, (size_t)(value / h.max * COMPONENT_BINS));
+    // unsigned wrap-around: a removal always follows the matching addition
+    h.bins[bin] += (uint64_t)(int64_t)sign;
+    h.sumMicros += (uint64_t)(int64_t)sign * toMicros(value);
+}
+
+void updateSketch(ScoreSketch& s, const ScoreParts& parts, const uint8_t* hasRequired, int sign)
+{
+    const uint64_t delta = (uint64_t)(int64_t)sign;
+    s.count += delta;
+    s.scoreBins[min(SCORE_BINS - 1, (size_t)(max(parts.total, 0.0) * (SCORE_BINS / 100)))] += delta;
+    s.scoreSumMicros += delta * toMicros(parts.total);
+    addComponent(s.skills, parts.skills, sign);
+    addComponent(s.experience, parts.experience, sign);
+    addComponent(s.gpa, parts.gpa, sign);
+    addComponent(s.certs, parts.certs, sign);
+    for (size_t r = 0; r < s.requiredSkills.size(); ++r) {
+        if (!hasRequired[r]) s.missing[r] += delta;
+    }
+}
+
+static void mergeComponent(ComponentHistogram& into, const ComponentHistogram& from)
+{
+    for (size_t b = 0; b < COMPONENT_BINS; ++b) into.bins[b] += from.bins[b];
+    into.sumMicros += from.sumMicros;
+}
+
+void mergeSketch(ScoreSketch& into, const ScoreSketch& from)
+{
+    into.count += from.count;
+    for (size_t b = 0; b < SCORE_BINS; ++b) into.scoreBins[b] += from.scoreBins[b];
+    into.scoreSumMicros += from.scoreSumMicros;
+    mergeComponent(into.skills, from.skills);
+    mergeComponent(into.experience, from.experience);
+    mergeComponent(into.gpa, from.gpa);
+    mergeComponent(into.certs, from.certs);
+    // same job, so the same skills; matched by id all the same, as one sketch may
+    // have been read back from a shard
+    for (size_t r = 0; r < from.requiredSkills.size(); ++r) {
+        auto it = lower_bound(into.requiredSkills.begin(), into.requiredSkills.end(), from.requiredSkills[r]);
+        if (it != into.requiredSkills.end() && *it == from.requiredSkills[r]) into.missing[it - into.requiredSkills.begin()] += from.missing[r];
+    }
+}
+
+double sketchPercentile(const ScoreSketch& s, double q)
+{
+    if (s.count == 0) return 0.0;
+    const uint64_t rank = max<uint64_t>(1, (uint64_t)ceil(q * (double)s.count));
+    uint64_t seen = 0;
+    for (size_t b = 0; b < SCORE_BINS; ++b) {
+        seen += s.scoreBins[b];
+        if (seen >= rank) return (double)(b + 1) * 100.0 / SCORE_BINS;     // the bin's upper edge
+    }
+    return 100.0;
+}
+
+double sketchMean(const ScoreSketch& s)
+{
+    return s.count ? (double)s.scoreSumMicros / 1e6 / (double)s.count : 0.0;
+}
+
+double componentMean(const ScoreSketch& s, const ComponentHistogram& h)
+{
+    return s.count ? (double)h.sumMicros / 1e6 / (double)s.count : 0.0;
+}
+
+template <class T>
+static void put(ostream& out, const T& value)
+{
+    out.write((const char*)&value, sizeof(value));
+}
+
+static void putComponent(ostream& out, const ComponentHistogram& h)
+{
+    put(out, h.max);
+    out.write((const char*)h.bins, sizeof(h.bins));
+    put(out, h.sumMicros);
+}
+
+void writeSketch(ostream& out, const ScoreSketch& s)
+{
+    put(out, s.count);
+    put(out, s.scoreSumMicros);
+    out.write((const char*)s.scoreBins, sizeof(s.scoreBins));
+    putComponent(out, s.skills);
+    putComponent(out, s.experience);
+    putComponent(out, s.gpa);
+    putComponent(out, s.certs);
+    put(out, (uint32_t)s.requiredSkills.size());
+    for (size_t r = 0; r < s.requiredSkills.size(); ++r) {
+        const string_view name = skillName(s.requiredSkills[r]);
+        put(out, (uint32_t)name.size());
+        out.write(name.data(), (streamsize)name.size());
+        put(out, s.missing[r]);
+    }
+}
+
+// copies length bytes from data + pos, if there are that many left
+static bool take(const char* data, size_t size, size_t& pos, void* into, size_t length)
+{
+    if (length > size - pos) return false;
+    memcpy(into, data + pos, length);
+    pos += length;
+    return true;
+}
+
+static bool takeComponent(const char* data, size_t size, size_t& pos, ComponentHistogram& h)
+{
+    return take(data, size, pos, &h.max, sizeof(h.max)) && take(data, size, pos, h.bins, sizeof(h.bins))
+        && take(data, size, pos, &h.sumMicros, sizeof(h.sumMicros));
+}
+
+bool readSketch(const char* data, size_t size, ScoreSketch& s, size_t* used)
+{
+    ScoreSketch r;
+    size_t pos = 0;
+    uint32_t required = 0;
+    if (!take(data, size, pos, &r.count, sizeof(r.count)) || !take(data, size, pos, &r.scoreSumMicros, sizeof(r.scoreSumMicros))
+        || !take(data, size, pos, r.scoreBins, sizeof(r.scoreBins))
+        || !takeComponent(data, size, pos, r.skills) || !takeComponent(data, size, pos, r.experience)
+        || !takeComponent(data, size, pos, r.gpa) || !takeComponent(data, size, pos, r.certs)
+        || !take(data, size, pos, &required, sizeof(required))) {
+        return false;
+    }
+    // re-interned, then kept in id order like a sketch started here
+    vector<pair<uint32_t, uint64_t>> skills;
+    for (uint32_t k = 0; k < required; ++k) {
+        uint32_t length = 0;
+        uint64_t missing = 0;
+        if (!take(data, size, pos, &length, sizeof(length)) || length > size - pos) return false;
+        const string_view name(data + pos, length);
+        pos += length;
+        if (!take(data, size, pos, &missing, sizeof(missing))) return false;
+        skills.emplace_back(internSkill(name), missing);
+    }
+    sort(skills.begin(), skills.end());
+    for (auto& sk : skills) {
+        r.requiredSkills.push_back(sk.first);
+        r.missing.push_back(sk.second);
+    }
+    s = move(r);
+    if (used) *used = pos;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include "parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+using namespace std;
+
+// Summary statistics of a scoring run for the report, gathered while candidates are
+// scored: the score distribution, a histogram per score component and how often each
+// required skill was missing. Memory does not grow with the number of candidates.
+//
+// Everything is a count in a fixed bin, or a sum in integer millionths of a point, so
+// sketches from different threads or shards merge exactly and in any order: a run
+// gives the same summary whatever the thread count or the number of shards.
+
+const size_t SCORE_BINS = 1000;         // 0.1 point each over 0 .. 100
+const size_t COMPONENT_BINS = 10;       // equal bins over 0 .. the component's weight
+
+// one candidate's score, split by component (the keyword part is the rest)
+struct ScoreParts {
+    double total = 0.0;
+    double skills = 0.0;
+    double experience = 0.0;
+    double gpa = 0.0;
+    double certs = 0.0;
+};
+
+struct ComponentHistogram {
+    double max = 0.0;                   // the profile's weight for the component
+    uint64_t bins[COMPONENT_BINS] = {};
+    uint64_t sumMicros = 0;             // sum of the values in millionths of a point
+};
+
+struct ScoreSketch {
+    uint64_t count = 0;
+    uint64_t scoreBins[SCORE_BINS] = {};
+    uint64_t scoreSumMicros = 0;
+    ComponentHistogram skills, experience, gpa, certs;
+    // required skills are few per job, so each gets an exact counter
+    vector<uint32_t> requiredSkills;    // the job's, in id order
+    vector<uint64_t> missing;           // candidates without requiredSkills[r]
+};
+
+// empty sketch for scoring against job: component ranges from its profile
+void startSketch(ScoreSketch& s, const Job& job);
+// Adds a scored candidate (sign +1) or takes it back out (sign -1, for --watch).
+// hasRequired[r] tells whether the candidate has requiredSkills[r].
+void updateSketch(ScoreSketch& s, const ScoreParts& parts, const uint8_t* hasRequired, int sign = 1);
+// adds `from` (started for the same job) to `into`
+void mergeSketch(ScoreSketch& into, const ScoreSketch& from);
+
+// score below which a fraction q of the candidates fall, to within a bin
+double sketchPercentile(const ScoreSketch& s, double q);
+double sketchMean(const ScoreSketch& s);
+double componentMean(const ScoreSketch& s, const ComponentHistogram& h);
+
+// Binary form for shard results. Skill ids are private to a process, so required
+// skills are stored by name and interned again when read.
+void writeSketch(ostream& out, const ScoreSketch& s);
+// reads a sketch from data; false if it is cut short. *used is set to its length.
+bool readSketch(const char* data, size_t size, ScoreSketch& s, size_t* used);
+
+#endif // SKETCH_H
@@ -0,0 +1,192 @@
+#include "skillalias.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+using namespace std;
+
+// Word-at-a-time hash of a short key. Tables are built and queried in the same
+// process, so byte order does not matter.
+static inline uint64_t keyHash(string_view s)
+{
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)s.size();
+    size_t i = 0;
+    for (; i + 8 <= s.size(); i += 8) {
+        uint64_t w;
+        memcpy(&w, s.data() + i, 8);
+        h = (h ^ w) * 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 29;
+    }
+    if (i < s.size()) {
+        uint64_t w = 0;
+        memcpy(&w, s.data() + i, s.size() - i);
+        h = (h ^ w) * 0xBF58476D1CE4E5B9ull;
+    }
+    h = (h ^ (h >> 31)) * 0x94D049BB133111EBull;
+    return h ^ (h >> 32);
+}
+
+// maps a 32-bit value onto [0, n) with a multiply instead of a division
+static inline uint32_t reduceRange(uint32_t x, size_t n)
+{
+    return (uint32_t)(((uint64_t)x * (uint64_t)n) >> 32);
+}
+
+static inline uint32_t bucketOf(uint64_t h, size_t buckets)
+{
+    return reduceRange((uint32_t)h, buckets);
+}
+
+// splitmix64 finalizer over the hash and the bucket's displacement
+static inline uint32_t slotOf(uint64_t h, uint32_t d, size_t slots)
+{
+    uint64_t x = h + (uint64_t)d * 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return reduceRange((uint32_t)(x >> 32), slots);
+}
+
+// Places every key in its own slot; false if some bucket finds no displacement
+// within the limit (only with very unlucky hashes; the caller retries with more buckets).
+static bool placeKeys(const vector<uint64_t>& hashes, size_t bucketCount, vector<uint32_t>& displacement, vector<uint32_t>& slotKey)
+{
+    const size_t n = hashes.size();
+    vector<vector<uint32_t>> buckets(bucketCount);
+    for (size_t i = 0; i < n; ++i) buckets[bucketOf(hashes[i], bucketCount)].push_back((uint32_t)i);
+
+    // biggest buckets first, while most slots are still free
+    vector<uint32_t> order(bucketCount);
+    for (size_t b = 0; b < bucketCount; ++b) order[b] = (uint32_t)b;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    const uint32_t NO_KEY = UINT32_MAX;
+    displacement.assign(bucketCount, 0);
+    slotKey.assign(n, NO_KEY);
+    vector<uint32_t> tried;
+    for (uint32_t b : order) {
+        const vector<uint32_t>& keys = buckets[b];
+        if (keys.empty()) break;
+        bool placed = false;
+        for (uint32_t d = 0; d < (1u << 20) && !placed; ++d) {
+            tried.clear();
+            placed = true;
+            for (uint32_t k : keys) {
+                uint32_t s = slotOf(hashes[k], d, n);
+                if (slotKey[s] != NO_KEY || find(tried.begin(), tried.end(), s) != tried.end()) {
+                    placed = false;
+                    break;
+                }
+                tried.push_back(s);
+            }
+            if (placed) {
+                displacement[b] = d;
+                for (size_t j = 0; j < keys.size(); ++j) slotKey[tried[j]] = keys[j];
+            }
+        }
+        if (!placed) return false;
+    }
+    return true;
+}
+
+bool buildAliasTable(AliasTable& t, const vector<pair<string, string>>& aliases)
+{
+    // one target per alias; identical repeats are harmless
+    unordered_map<string, string> target;
+    vector<string> keys;
+    for (auto& a : aliases) {
+        if (a.first.empty() || a.second.empty() || a.first == a.second) continue;
+        auto it = target.find(a.first);
+        if (it == target.end()) {
+            target.emplace(a.first, a.second);
+            keys.push_back(a.first);
+        }
+        else if (it->second != a.second) {
+            cout << "Skill alias \"" << a.first << "\" maps to both \"" << it->second << "\" and \"" << a.second << "\"\n";
+            return false;
+        }
+    }
+
+    AliasTable out;
+    const size_t n = keys.size();
+    vector<uint64_t> hashes(n);
+    vector<string> finalName(n);
+    for (size_t i = 0; i < n; ++i) {
+        hashes[i] = keyHash(keys[i]);
+        // follow the chain to a name that is not itself an alias
+        string name = target[keys[i]];
+        for (size_t hops = 0;; ++hops) {
+            auto it = target.find(name);
+            if (it == target.end()) break;
+            if (hops == n) {
+                cout << "Skill alias \"" << keys[i] << "\" is part of a cycle\n";
+                return false;
+            }
+            name = it->second;
+        }
+        finalName[i] = move(name);
+    }
+
+    if (n > 0) {
+        vector<uint32_t> slotKey;
+        size_t bucketCount = (n + 3) / 4;
+        while (!placeKeys(hashes, bucketCount, out.displacement, slotKey)) {
+            // two keys with the same 64-bit hash can never be separated
+            if (bucketCount >= n) {
+                cout << "Cannot build the skill alias table: hash collision\n";
+                return false;
+            }
+            bucketCount = min(n, bucketCount * 2);
+        }
+
+        out.slots.resize(n);
+        out.minKeyLength = SIZE_MAX;
+        for (size_t s = 0; s < n; ++s) {
+            const string& key = keys[slotKey[s]];
+            const string& value = finalName[slotKey[s]];
+            AliasSlot& slot = out.slots[s];
+            slot.keyOffset = (uint32_t)out.text.size();
+            slot.keyLength = (uint32_t)key.size();
+            out.text += key;
+            slot.valueOffset = (uint32_t)out.text.size();
+            slot.valueLength = (uint32_t)value.size();
+            out.text += value;
+            out.minKeyLength = min(out.minKeyLength, key.size());
+            out.maxKeyLength = max(out.maxKeyLength, key.size());
+        }
+    }
+    t = move(out);
+    return true;
+}
+
+bool findAlias(const AliasTable& t, string_view key, string_view& canonical)
+{
+    if (key.size() < t.minKeyLength || key.size() > t.maxKeyLength || t.slots.empty()) return false;
+    const uint64_t h = keyHash(key);
+    const uint32_t d = t.displacement[bucketOf(h, t.displacement.size())];
+    const AliasSlot& s = t.slots[slotOf(h, d, t.slots.size())];
+    if (s.keyLength != key.size() || memcmp(t.text.data() + s.keyOffset, key.data(), key.size()) != 0) return false;
+    canonical = string_view(t.text.data() + s.valueOffset, s.valueLength);
+    return true;
+}
+
+static AliasTable& aliasTable()
+{
+    static AliasTable t = [] {
+        AliasTable builtIn;
+        buildAliasTable(builtIn, { { "cpp", "c++" }, { "js", "javascript" } });
+        return builtIn;
+    }();
+    return t;
+}
+
+const AliasTable& skillAliases()
+{
+    return aliasTable();
+}
+
+void setSkillAliases(AliasTable&& t)
+{
+    aliasTable() = move(t);
+}
@@ -0,0 +1,43 @@
+#ifndef SKILLALIAS_H
+#define SKILLALIAS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Alias -> canonical skill name table ("golang" -> "go", "k8s" -> "kubernetes"),
+// compiled into a minimal perfect hash by hash and displace: the key's hash picks a
+// bucket, the bucket's displacement picks the only slot the key can be in, and one
+// compare confirms it. Lookups take constant time and never allocate.
+struct AliasSlot {
+    uint32_t keyOffset = 0, keyLength = 0;      // into AliasTable::text
+    uint32_t valueOffset = 0, valueLength = 0;
+};
+
+struct AliasTable {
+    string text;                    // every alias and canonical name back to back
+    vector<AliasSlot> slots;        // exactly one per alias
+    vector<uint32_t> displacement;  // one per bucket
+    size_t minKeyLength = 0;        // keys outside this range are rejected unhashed
+    size_t maxKeyLength = 0;
+};
+
+// Builds t from (alias, canonical) pairs, both already normalized (lowercase,
+// trimmed). Chains such as a -> b, b -> c are followed so every alias maps straight
+// to its final name. False (after a message) on a cycle or on an alias listed twice
+// with different targets.
+bool buildAliasTable(AliasTable& t, const vector<pair<string, string>>& aliases);
+// canonical name for key, which must be normalized; false if key is not an alias
+bool findAlias(const AliasTable& t, string_view key, string_view& canonical);
+
+// The process-wide table behind appendNormalizedSkill. Holds the built-in "cpp" and
+// "js" aliases until setSkillAliases() replaces it; like loadDictionary, call that
+// before parsing starts, since lookups are not locked.
+const AliasTable& skillAliases();
+void setSkillAliases(AliasTable&& t);
+
+#endif // SKILLALIAS_H
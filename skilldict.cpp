@@ -0,0 +1,74 @@
+#include "skilldict.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// names live in a deque so the string_views handed out (and used as map keys)
+// stay valid while new skills are added
+static shared_mutex dictMutex;
+static deque<string> names;
+static unordered_map<string_view, uint32_t> ids;
+
+uint32_t internSkill(string_view normalized)
+{
+    {
+        shared_lock<shared_mutex> lock(dictMutex);
+        auto it = ids.find(normalized);
+        if (it != ids.end()) return it->second;
+    }
+    unique_lock<shared_mutex> lock(dictMutex);
+    auto it = ids.find(normalized); // another thread may have added it meanwhile
+    if (it != ids.end()) return it->second;
+    uint32_t id = (uint32_t)names.size();
+    names.emplace_back(normalized);
+    ids.emplace(string_view(names.back()), id);
+    return id;
+}
+
+string_view skillName(uint32_t id)
+{
+    shared_lock<shared_mutex> lock(dictMutex);
+    return id < names.size() ? string_view(names[id]) : string_view();
+}
+
+size_t skillCount()
+{
+    shared_lock<shared_mutex> lock(dictMutex);
+    return names.size();
+}
+
+static int popcount64(uint64_t x)
+{
+#ifdef _MSC_VER
+    return (int)__popcnt64(x);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+void addSkill(SkillSet& set, uint32_t id)
+{
+    size_t word = id / 64;
+    if (word >= set.bits.size()) set.bits.resize(word + 1, 0);
+    set.bits[word] |= (uint64_t)1 << (id % 64);
+}
+
+bool hasSkill(const SkillSet& set, uint32_t id)
+{
+    size_t word = id / 64;
+    return word < set.bits.size() && (set.bits[word] >> (id % 64) & 1) != 0;
+}
+
+size_t skillSetSize(const SkillSet& set)
+{
+    size_t n = 0;
+    for (uint64_t w : set.bits) n += popcount64(w);
+    return n;
+}
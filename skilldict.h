@@ -0,0 +1,27 @@
+#ifndef SKILLDICT_H
+#define SKILLDICT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Process-wide skill interner: every normalized skill name gets a dense id the first
+// time it is seen, so resumes and jobs can compare skills as integers. Safe to call
+// from the parser threads.
+uint32_t internSkill(string_view normalized);
+string_view skillName(uint32_t id);
+size_t skillCount();
+
+// set of skill ids as a bitset indexed by id
+struct SkillSet {
+    vector<uint64_t> bits;
+};
+
+void addSkill(SkillSet& set, uint32_t id);
+bool hasSkill(const SkillSet& set, uint32_t id);
+size_t skillSetSize(const SkillSet& set);
+
+#endif // SKILLDICT_H
@@ -0,0 +1,558 @@
+#include "snapshot.h"
+#include "candidatepool.h"
+#include "mappedfile.h"
+#include "skilldict.h"
+#include "stats.h"
+#include "allocstats.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+using namespace std;
+
+/*
+ Layout (host byte order; byteOrder tells a foreign file apart):
+   SnapshotHeader
+   SnapshotRecord[candidateCount]
+   TextSpan[spanCount]         certifications of all candidates, back to back
+   uint32_t[skillRefCount]     skills of all candidates, as skill table indices
+   uint32_t[skillCount + 1]    skill table: offsets into the skill name bytes
+   char[]                      skill name bytes
+   FileStamp[stampCount]       per-candidate file stamps (ingest cache only, else empty)
+   char[]                      candidate text bytes
+   PoolHeader                  at poolOffset, when the snapshot holds a pool (savePoolSnapshot)
+   pool sections               in PoolSection order, each as the pool or index column it becomes
+ Every section starts on an 8-byte boundary.
+*/
+
+static const char SNAPSHOT_MAGIC[8] = { 'R', 'F', 'S', 'N', 'A', 'P', '\0', '\0' };
+static const uint32_t SNAPSHOT_VERSION = 4;
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t candidateCount;
+    uint64_t spanCount;
+    uint64_t skillRefCount;
+    uint64_t skillCount;
+    uint64_t stampCount;
+    uint64_t tag;
+    uint64_t recordsOffset;
+    uint64_t spansOffset;
+    uint64_t skillRefsOffset;
+    uint64_t skillTableOffset;
+    uint64_t skillNamesOffset;
+    uint64_t stampsOffset;
+    uint64_t textOffset;
+    uint64_t poolOffset;    // 0 = no pool sections; the text then runs to the end
+    uint64_t fileSize;
+};
+
+struct SnapshotRecord {
+    uint64_t textOffset;    // relative to the text section
+    uint32_t textLength;
+    TextSpan name;
+    TextSpan education;
+    TextSpan filepath;
+    uint32_t firstCert;
+    uint32_t certCount;
+    uint32_t firstSkill;
+    uint32_t skillCount;
+    int32_t experienceYears;
+    double gpa;
+    uint32_t inputIndex;
+};
+
+// The scoring pool's parse results and its keyword index, one section per column.
+// Pool skill ids are snapshot skill table indices like the candidates' ones.
+enum PoolSection {
+    POOL_TEXT, POOL_NAME, POOL_EDUCATION, POOL_FILEPATH, POOL_GPA, POOL_YEARS,
+    POOL_SKILL_START, POOL_SKILL_IDS, POOL_CERT_START, POOL_CERTS,
+    POOL_DUPLICATE_START, POOL_DUPLICATES,
+    POOL_TERM_WORDS, POOL_POSTING_START, POOL_POSTING_DOCS, POOL_POSTING_COUNTS,
+    POOL_DOC_LENGTH, POOL_LENGTH_NORM,
+    POOL_SECTION_COUNT
+};
+
+static const uint64_t POOL_ELEMENT_SIZE[POOL_SECTION_COUNT] = {
+    1, sizeof(TextSpan), sizeof(TextSpan), sizeof(TextSpan), sizeof(double), sizeof(int32_t),
+    sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(TextSpan),
+    sizeof(uint32_t), sizeof(TextSpan),
+    sizeof(uint64_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t),
+    sizeof(uint32_t), sizeof(double)
+};
+
+struct PoolHeader {
+    uint64_t offset[POOL_SECTION_COUNT];    // relative to the snapshot's start
+    uint64_t count[POOL_SECTION_COUNT];     // elements, not bytes
+};
+
+static uint64_t align8(uint64_t v)
+{
+    return (v + 7) & ~(uint64_t)7;
+}
+
+static void writePadding(ostream& out, uint64_t& pos, uint64_t target)
+{
+    static const char zeros[8] = {};
+    out.write(zeros, (streamsize)(target - pos));
+    pos = target;
+}
+
+bool writeSnapshot(ostream& out, const vector<Candidate>& candidates, const vector<FileStamp>* stamps, uint64_t tag,
+                   const CandidatePool* pool)
+{
+    if (stamps && stamps->size() != candidates.size()) return false;
+    uint64_t stampCount = stamps ? stamps->size() : 0;
+
+    // local skill table: snapshot index per interned id, in first-use order
+    unordered_map<uint32_t, uint32_t> localIndex;
+    vector<uint32_t> tableIds;
+    vector<SnapshotRecord> records(candidates.size());
+    vector<TextSpan> spans;
+    vector<uint32_t> skillRefs;
+    uint64_t textBytes = 0;
+    auto tableIndex = [&](uint32_t id) {
+        auto it = localIndex.find(id);
+        if (it == localIndex.end()) {
+            it = localIndex.emplace(id, (uint32_t)tableIds.size()).first;
+            tableIds.push_back(id);
+        }
+        return it->second;
+    };
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const Candidate& c = candidates[i];
+        SnapshotRecord& r = records[i]; // value-initialized, so no stray bytes reach the file
+        r.textOffset = textBytes;
+        r.textLength = (uint32_t)c.text.size();
+        r.name = c.name;
+        r.education = c.education;
+        r.filepath = c.filepath;
+        r.firstCert = (uint32_t)spans.size();
+        r.certCount = (uint32_t)c.certifications.size();
+        spans.insert(spans.end(), c.certifications.begin(), c.certifications.end());
+        r.firstSkill = (uint32_t)skillRefs.size();
+        r.skillCount = (uint32_t)c.skills.size();
+        for (uint32_t id : c.skills) skillRefs.push_back(tableIndex(id));
+        r.experienceYears = c.experienceYears;
+        r.gpa = c.gpa;
+        r.inputIndex = c.inputIndex;
+        textBytes += c.text.size();
+    }
+    vector<uint32_t> poolSkillRefs;
+    if (pool) {
+        poolSkillRefs.reserve(pool->skillIds.size());
+        for (uint32_t id : pool->skillIds) poolSkillRefs.push_back(tableIndex(id));
+    }
+
+    vector<uint32_t> table;
+    string names;
+    for (uint32_t id : tableIds) {
+        table.push_back((uint32_t)names.size());
+        names += skillName(id);
+    }
+    table.push_back((uint32_t)names.size());
+
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.candidateCount = records.size();
+    h.spanCount = spans.size();
+    h.skillRefCount = skillRefs.size();
+    h.skillCount = tableIds.size();
+    h.stampCount = stampCount;
+    h.tag = tag;
+    h.recordsOffset = align8(sizeof(h));
+    h.spansOffset = align8(h.recordsOffset + records.size() * sizeof(SnapshotRecord));
+    h.skillRefsOffset = align8(h.spansOffset + spans.size() * sizeof(TextSpan));
+    h.skillTableOffset = align8(h.skillRefsOffset + skillRefs.size() * sizeof(uint32_t));
+    h.skillNamesOffset = align8(h.skillTableOffset + table.size() * sizeof(uint32_t));
+    h.stampsOffset = align8(h.skillNamesOffset + names.size());
+    h.textOffset = align8(h.stampsOffset + stampCount * sizeof(FileStamp));
+    h.fileSize = h.textOffset + textBytes;
+
+    PoolHeader ph;
+    memset(&ph, 0, sizeof(ph));
+    const void* sections[POOL_SECTION_COUNT] = {};
+    if (pool) {
+        const TextIndex& index = pool->keywordIndex;
+        const pair<const void*, size_t> columns[POOL_SECTION_COUNT] = {
+            { pool->text.data(), pool->text.size() },
+            { pool->name.data(), pool->name.size() },
+            { pool->education.data(), pool->education.size() },
+            { pool->filepath.data(), pool->filepath.size() },
+            { pool->gpa.data(), pool->gpa.size() },
+            { pool->years.data(), pool->years.size() },
+            { pool->skillStart.data(), pool->skillStart.size() },
+            { poolSkillRefs.data(), poolSkillRefs.size() },
+            { pool->certStart.data(), pool->certStart.size() },
+            { pool->certs.data(), pool->certs.size() },
+            { pool->duplicateStart.data(), pool->duplicateStart.size() },
+            { pool->duplicates.data(), pool->duplicates.size() },
+            { index.termWords.data(), index.termWords.size() },
+            { index.postingStart.data(), index.postingStart.size() },
+            { index.postingDocs.data(), index.postingDocs.size() },
+            { index.postingCounts.data(), index.postingCounts.size() },
+            { index.docLength.data(), index.docLength.size() },
+            { index.lengthNorm.data(), index.lengthNorm.size() },
+        };
+        h.poolOffset = align8(h.fileSize);
+        uint64_t end = h.poolOffset + sizeof(PoolHeader);
+        for (int s = 0; s < POOL_SECTION_COUNT; ++s) {
+            sections[s] = columns[s].first;
+            ph.count[s] = columns[s].second;
+            ph.offset[s] = align8(end);
+            end = ph.offset[s] + ph.count[s] * POOL_ELEMENT_SIZE[s];
+        }
+        h.fileSize = end;
+    }
+
+    uint64_t pos = 0;
+    out.write((const char*)&h, sizeof(h));
+    pos += sizeof(h);
+    writePadding(out, pos, h.recordsOffset);
+    out.write((const char*)records.data(), (streamsize)(records.size() * sizeof(SnapshotRecord)));
+    pos += records.size() * sizeof(SnapshotRecord);
+    writePadding(out, pos, h.spansOffset);
+    out.write((const char*)spans.data(), (streamsize)(spans.size() * sizeof(TextSpan)));
+    pos += spans.size() * sizeof(TextSpan);
+    writePadding(out, pos, h.skillRefsOffset);
+    out.write((const char*)skillRefs.data(), (streamsize)(skillRefs.size() * sizeof(uint32_t)));
+    pos += skillRefs.size() * sizeof(uint32_t);
+    writePadding(out, pos, h.skillTableOffset);
+    out.write((const char*)table.data(), (streamsize)(table.size() * sizeof(uint32_t)));
+    pos += table.size() * sizeof(uint32_t);
+    writePadding(out, pos, h.skillNamesOffset);
+    out.write(names.data(), (streamsize)names.size());
+    pos += names.size();
+    writePadding(out, pos, h.stampsOffset);
+    if (stamps) out.write((const char*)stamps->data(), (streamsize)(stampCount * sizeof(FileStamp)));
+    pos += stampCount * sizeof(FileStamp);
+    writePadding(out, pos, h.textOffset);
+    for (auto& c : candidates) out.write(c.text.data(), (streamsize)c.text.size());
+    pos += textBytes;
+    if (pool) {
+        writePadding(out, pos, h.poolOffset);
+        out.write((const char*)&ph, sizeof(ph));
+        pos += sizeof(ph);
+        for (int s = 0; s < POOL_SECTION_COUNT; ++s) {
+            writePadding(out, pos, ph.offset[s]);
+            out.write((const char*)sections[s], (streamsize)(ph.count[s] * POOL_ELEMENT_SIZE[s]));
+            pos += ph.count[s] * POOL_ELEMENT_SIZE[s];
+        }
+    }
+    return (bool)out;
+}
+
+static bool writeSnapshotFile(const string& path, const vector<Candidate>& candidates, const vector<FileStamp>* stamps,
+                              uint64_t tag, const CandidatePool* pool)
+{
+    if (stamps && stamps->size() != candidates.size()) return false;
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        cout << "Cannot write snapshot: " << path << "\n";
+        return false;
+    }
+    bool ok = writeSnapshot(out, candidates, stamps, tag, pool);
+    out.close();
+    if (!ok || !out) {
+        cout << "Failed writing snapshot: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool saveSnapshot(const string& path, const vector<Candidate>& candidates, const vector<FileStamp>* stamps, uint64_t tag)
+{
+    RF_TIMED_SCOPE("save snapshot");
+    return writeSnapshotFile(path, candidates, stamps, tag, nullptr);
+}
+
+bool savePoolSnapshot(const string& path, const vector<Candidate>& candidates)
+{
+    RF_TIMED_SCOPE("save snapshot");
+    RF_ALLOC_STAGE(ALLOC_SCORE);
+    // the pool poolFromCandidates would build, without consuming the candidates
+    CandidatePool pool;
+    for (auto& c : candidates) {
+        addToPool(pool, c);
+        addDocument(pool.keywordIndex, resumeText(c));
+    }
+    finishTextIndex(pool.keywordIndex);
+    return writeSnapshotFile(path, candidates, nullptr, 0, &pool);
+}
+
+// true if [offset, offset + count * size) ends before `next`, where the following
+// section starts
+static bool sectionFits(uint64_t offset, uint64_t count, uint64_t size, uint64_t next)
+{
+    if (offset > next) return false;
+    return count <= (next - offset) / (size ? size : 1);
+}
+
+static bool spanFits(TextSpan s, uint32_t textLength)
+{
+    return (uint64_t)s.offset + s.length <= textLength;
+}
+
+// reads and checks the header; false (with the message printed) if the sections do
+// not fit the file
+static bool readHeader(const char* data, size_t size, const string& path, SnapshotHeader& h)
+{
+    if (size < sizeof(h)) {
+        cout << "Not a snapshot file: " << path << "\n";
+        return false;
+    }
+    memcpy(&h, data, sizeof(h));
+    if (memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 || h.byteOrder != BYTE_ORDER_MARK) {
+        cout << "Not a snapshot file: " << path << "\n";
+        return false;
+    }
+    if (h.version != SNAPSHOT_VERSION) {
+        cout << "Unsupported snapshot version " << h.version << " in " << path << "\n";
+        return false;
+    }
+    // sections in file order, each ending before the next one starts, so the sizes
+    // taken from neighbouring offsets below cannot wrap around
+    const uint64_t textEnd = h.poolOffset ? h.poolOffset : h.fileSize;
+    if (h.fileSize != size || h.skillCount >= h.fileSize || h.recordsOffset < sizeof(h)
+        || !sectionFits(h.recordsOffset, h.candidateCount, sizeof(SnapshotRecord), h.spansOffset)
+        || !sectionFits(h.spansOffset, h.spanCount, sizeof(TextSpan), h.skillRefsOffset)
+        || !sectionFits(h.skillRefsOffset, h.skillRefCount, sizeof(uint32_t), h.skillTableOffset)
+        || !sectionFits(h.skillTableOffset, h.skillCount + 1, sizeof(uint32_t), h.skillNamesOffset)
+        || !sectionFits(h.skillNamesOffset, 0, 1, h.stampsOffset)
+        || (h.stampCount != 0 && h.stampCount != h.candidateCount)
+        || !sectionFits(h.stampsOffset, h.stampCount, sizeof(FileStamp), h.textOffset)
+        || !sectionFits(h.textOffset, 0, 1, textEnd) || textEnd > h.fileSize) {
+        cout << "Corrupt snapshot: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// re-interns the snapshot's skill table; remap[i] is the id of table entry i
+static bool internSkillTable(const char* base, const SnapshotHeader& h, const string& path, vector<uint32_t>& remap)
+{
+    vector<uint32_t> table(h.skillCount + 1);
+    memcpy(table.data(), base + h.skillTableOffset, table.size() * sizeof(uint32_t));
+    uint64_t namesSize = h.stampsOffset - h.skillNamesOffset;
+    remap.resize(h.skillCount);
+    for (uint64_t i = 0; i < h.skillCount; ++i) {
+        if (table[i] > table[i + 1] || table[i + 1] > namesSize) {
+            cout << "Corrupt snapshot: " << path << "\n";
+            return false;
+        }
+        remap[i] = internSkill(string_view(base + h.skillNamesOffset + table[i], table[i + 1] - table[i]));
+    }
+    return true;
+}
+
+bool readSnapshot(const char* data, size_t size, const string& path, vector<Candidate>& candidates, vector<FileStamp>* stamps, uint64_t* tag)
+{
+    SnapshotHeader h;
+    if (!readHeader(data, size, path, h)) return false;
+
+    // re-intern the snapshot's skill table once; records then map indices to ids
+    const char* base = data;
+    vector<uint32_t> remap;
+    if (!internSkillTable(base, h, path, remap)) return false;
+
+    uint64_t textSize = (h.poolOffset ? h.poolOffset : h.fileSize) - h.textOffset;
+    const char* spans = base + h.spansOffset;
+    const char* refs = base + h.skillRefsOffset;
+    vector<Candidate> result(h.candidateCount);
+    for (uint64_t i = 0; i < h.candidateCount; ++i) {
+        SnapshotRecord r;
+        memcpy(&r, base + h.recordsOffset + i * sizeof(SnapshotRecord), sizeof(r));
+        if (r.textOffset > textSize || r.textLength > textSize - r.textOffset
+            || (uint64_t)r.firstCert + r.certCount > h.spanCount
+            || (uint64_t)r.firstSkill + r.skillCount > h.skillRefCount
+            || !spanFits(r.name, r.textLength) || !spanFits(r.education, r.textLength)
+            || !spanFits(r.filepath, r.textLength)) {
+            cout << "Corrupt snapshot: " << path << "\n";
+            return false;
+        }
+
+        Candidate& c = result[i];
+        c.text.assign(base + h.textOffset + r.textOffset, r.textLength);
+        c.name = r.name;
+        c.education = r.education;
+        c.filepath = r.filepath;
+        c.gpa = r.gpa;
+        c.experienceYears = r.experienceYears;
+        c.inputIndex = r.inputIndex;
+        c.certifications.resize(r.certCount);
+        if (r.certCount) memcpy(c.certifications.data(), spans + (uint64_t)r.firstCert * sizeof(TextSpan), r.certCount * sizeof(TextSpan));
+        for (auto& s : c.certifications) {
+            if (!spanFits(s, r.textLength)) {
+                cout << "Corrupt snapshot: " << path << "\n";
+                return false;
+            }
+        }
+        c.skills.resize(r.skillCount);
+        for (uint32_t k = 0; k < r.skillCount; ++k) {
+            uint32_t idx;
+            memcpy(&idx, refs + ((uint64_t)r.firstSkill + k) * sizeof(uint32_t), sizeof(idx));
+            if (idx >= h.skillCount) {
+                cout << "Corrupt snapshot: " << path << "\n";
+                return false;
+            }
+            c.skills[k] = remap[idx];
+        }
+    }
+
+    if (stamps) {
+        stamps->assign(h.stampCount, FileStamp());
+        if (h.stampCount) memcpy(stamps->data(), base + h.stampsOffset, h.stampCount * sizeof(FileStamp));
+    }
+    if (tag) *tag = h.tag;
+    candidates = move(result);
+    return true;
+}
+
+bool loadSnapshot(const string& path, vector<Candidate>& candidates, vector<FileStamp>* stamps, uint64_t* tag)
+{
+    RF_TIMED_SCOPE("load snapshot");
+    RF_ALLOC_STAGE(ALLOC_PARSE);
+    MappedFile f;
+    if (!mapFile(f, path)) {
+        cout << "Cannot open snapshot: " << path << "\n";
+        return false;
+    }
+    return readSnapshot(f.data, f.size, path, candidates, stamps, tag);
+}
+
+template <class T>
+static Column<T> poolColumn(const char* base, const PoolHeader& ph, PoolSection s)
+{
+    return Column<T>{ (const T*)(base + ph.offset[s]), (size_t)ph.count[s] };
+}
+
+// a start column for `count` entries over a list of `total` items
+static bool startsFit(Column<uint32_t> start, uint64_t count, uint64_t total)
+{
+    if (start.size() != count + 1 || start[0] != 0 || start[count] != total) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (start[i + 1] < start[i]) return false;
+    }
+    return true;
+}
+
+static bool spansFit(Column<TextSpan> spans, uint64_t textBytes)
+{
+    for (TextSpan s : spans) {
+        if ((uint64_t)s.offset + s.length > textBytes) return false;
+    }
+    return true;
+}
+
+// Points pool's columns into the mapped pool sections after checking everything a
+// reader indexes with: section bounds and alignment, column sizes, start columns,
+// text spans, skill ids and the keyword index. Nothing is copied unless the skill ids
+// need translating (see below).
+static bool viewPoolSections(const char* base, const SnapshotHeader& h, const string& path, CandidatePool& pool)
+{
+    PoolHeader ph;
+    bool ok = ((uintptr_t)base % 8) == 0 && h.poolOffset % 8 == 0
+        && sectionFits(h.poolOffset, 1, sizeof(PoolHeader), h.fileSize);
+    if (ok) {
+        memcpy(&ph, base + h.poolOffset, sizeof(ph));
+        uint64_t end = h.poolOffset + sizeof(PoolHeader);
+        for (int s = 0; s < POOL_SECTION_COUNT && ok; ++s) {
+            ok = ph.offset[s] % 8 == 0 && ph.offset[s] >= end
+                && sectionFits(ph.offset[s], ph.count[s], POOL_ELEMENT_SIZE[s], h.fileSize);
+            end = ph.offset[s] + ph.count[s] * POOL_ELEMENT_SIZE[s];
+        }
+    }
+    if (!ok) {
+        cout << "Corrupt snapshot: " << path << "\n";
+        return false;
+    }
+
+    const uint64_t n = ph.count[POOL_GPA];
+    const uint64_t textBytes = ph.count[POOL_TEXT];
+    const Column<uint32_t> skillIds = poolColumn<uint32_t>(base, ph, POOL_SKILL_IDS);
+    ok = ph.count[POOL_NAME] == n && ph.count[POOL_EDUCATION] == n && ph.count[POOL_FILEPATH] == n
+        && ph.count[POOL_YEARS] == n && ph.count[POOL_DOC_LENGTH] == n
+        && startsFit(poolColumn<uint32_t>(base, ph, POOL_SKILL_START), n, ph.count[POOL_SKILL_IDS])
+        && startsFit(poolColumn<uint32_t>(base, ph, POOL_CERT_START), n, ph.count[POOL_CERTS])
+        && startsFit(poolColumn<uint32_t>(base, ph, POOL_DUPLICATE_START), n, ph.count[POOL_DUPLICATES])
+        && spansFit(poolColumn<TextSpan>(base, ph, POOL_NAME), textBytes)
+        && spansFit(poolColumn<TextSpan>(base, ph, POOL_EDUCATION), textBytes)
+        && spansFit(poolColumn<TextSpan>(base, ph, POOL_FILEPATH), textBytes)
+        && spansFit(poolColumn<TextSpan>(base, ph, POOL_CERTS), textBytes)
+        && spansFit(poolColumn<TextSpan>(base, ph, POOL_DUPLICATES), textBytes);
+    for (size_t k = 0; ok && k < skillIds.size(); ++k) ok = skillIds[k] < h.skillCount;
+    ok = ok && viewTextIndex(pool.keywordIndex, poolColumn<uint64_t>(base, ph, POOL_TERM_WORDS),
+                             poolColumn<uint32_t>(base, ph, POOL_POSTING_START), poolColumn<uint32_t>(base, ph, POOL_POSTING_DOCS),
+                             poolColumn<uint32_t>(base, ph, POOL_POSTING_COUNTS), poolColumn<uint32_t>(base, ph, POOL_DOC_LENGTH),
+                             poolColumn<double>(base, ph, POOL_LENGTH_NORM));
+    if (!ok) {
+        cout << "Corrupt snapshot: " << path << "\n";
+        return false;
+    }
+    vector<uint32_t> remap;
+    if (!internSkillTable(base, h, path, remap)) return false;
+
+    pool.text = poolColumn<char>(base, ph, POOL_TEXT);
+    pool.name = poolColumn<TextSpan>(base, ph, POOL_NAME);
+    pool.education = poolColumn<TextSpan>(base, ph, POOL_EDUCATION);
+    pool.filepath = poolColumn<TextSpan>(base, ph, POOL_FILEPATH);
+    pool.gpa = poolColumn<double>(base, ph, POOL_GPA);
+    pool.years = poolColumn<int32_t>(base, ph, POOL_YEARS);
+    pool.skillStart = poolColumn<uint32_t>(base, ph, POOL_SKILL_START);
+    pool.certStart = poolColumn<uint32_t>(base, ph, POOL_CERT_START);
+    pool.certs = poolColumn<TextSpan>(base, ph, POOL_CERTS);
+    pool.duplicateStart = poolColumn<uint32_t>(base, ph, POOL_DUPLICATE_START);
+    pool.duplicates = poolColumn<TextSpan>(base, ph, POOL_DUPLICATES);
+    // In a fresh process the table is the first thing interned, so its indices are
+    // the interned ids and the stored column is used as it is; otherwise the ids are
+    // translated into a copy.
+    bool identity = true;
+    for (size_t i = 0; i < remap.size() && identity; ++i) identity = remap[i] == i;
+    if (identity) {
+        pool.skillIds = skillIds;
+    }
+    else {
+        pool.own.skillIds.resize(skillIds.size());
+        for (size_t k = 0; k < skillIds.size(); ++k) pool.own.skillIds[k] = remap[skillIds[k]];
+        pool.skillIds = columnOf(pool.own.skillIds);
+    }
+    pool.score.assign(n, 0.0);
+    pool.grade.assign(n, 'D');
+    pool.matchedSkillStart.assign(n + 1, 0);
+    pool.matchedCertStart.assign(n + 1, 0);
+    return true;
+}
+
+bool loadPoolSnapshot(const string& path, CandidatePool& pool)
+{
+    RF_TIMED_SCOPE("load snapshot");
+    RF_ALLOC_STAGE(ALLOC_PARSE);
+    auto f = make_shared<MappedFile>();
+    if (!mapFile(*f, path)) {
+        cout << "Cannot open snapshot: " << path << "\n";
+        return false;
+    }
+    SnapshotHeader h;
+    if (!readHeader(f->data, f->size, path, h)) return false;
+    if (h.poolOffset == 0) {
+        // an ingest cache holds candidates only: pool them here
+        vector<Candidate> candidates;
+        if (!readSnapshot(f->data, f->size, path, candidates)) return false;
+        pool = poolFromCandidates(move(candidates));
+        return true;
+    }
+    CandidatePool mapped;
+    if (!viewPoolSections(f->data, h, path, mapped)) return false;
+    mapped.mapping = move(f);
+    pool = move(mapped);
+    return true;
+}
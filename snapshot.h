@@ -0,0 +1,47 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "parser.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct CandidatePool;
+
+// Binary snapshot of a parsed candidate pool, so a run can skip parsing the resume
+// folder. The file is a fixed header followed by flat arrays (candidate records,
+// certification spans, skill ids, the skill name table and all candidate text) and
+// is read through a memory mapping. Skill ids are stored against the snapshot's own
+// name table and re-interned on load. Only parse results are stored, not scores.
+// loadSnapshot copies each candidate out of the mapping into its own Candidate.
+// The ingest cache also stores one FileStamp per candidate and a tag identifying the
+// parser dictionary the candidates were built with.
+bool saveSnapshot(const string& path, const vector<Candidate>& candidates,
+                  const vector<FileStamp>* stamps = nullptr, uint64_t tag = 0);
+bool loadSnapshot(const string& path, vector<Candidate>& candidates,
+                  vector<FileStamp>* stamps = nullptr, uint64_t* tag = nullptr);
+
+// A snapshot that also holds the scoring pool and keyword index built from the
+// candidates (what poolFromCandidates makes of them), each column as its own aligned
+// section. loadPoolSnapshot checks those sections and points the pool's columns into
+// the mapping, which the pool keeps open: a warm start costs validation and pointer
+// setup, not copying or re-indexing. A snapshot without them (an ingest cache) is
+// read as candidates and pooled.
+bool savePoolSnapshot(const string& path, const vector<Candidate>& candidates);
+bool loadPoolSnapshot(const string& path, CandidatePool& pool);
+
+// The same format inside a larger file (shard.h): written at the stream's current
+// position, read from a byte range. Offsets in the snapshot are relative to its start;
+// `path` only names the file in error messages. With `pool`, its sections follow the
+// candidates' (savePoolSnapshot).
+bool writeSnapshot(ostream& out, const vector<Candidate>& candidates,
+                   const vector<FileStamp>* stamps = nullptr, uint64_t tag = 0,
+                   const CandidatePool* pool = nullptr);
+bool readSnapshot(const char* data, size_t size, const string& path, vector<Candidate>& candidates,
+                  vector<FileStamp>* stamps = nullptr, uint64_t* tag = nullptr);
+
+#endif // SNAPSHOT_H
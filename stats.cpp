@@ -0,0 +1,204 @@
+#include "stats.h"
+
+#if RF_STATS
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+bool statsActive = false;
+static bool traceActive = false;
+
+static const char* const COUNTER_NAMES[STAT_COUNTER_COUNT] = {
+    "files opened", "bytes read", "number scans", "skill comparisons",
+    "postings read", "io_uring enters",
+    "grade A", "grade B", "grade C", "grade D",
+};
+
+struct StageTotal {
+    const char* name;
+    uint64_t calls = 0;
+    int64_t totalNs = 0;
+};
+
+struct TraceEvent {
+    const char* name;
+    int64_t startNs;
+    int64_t durationNs;
+};
+
+// Everything one thread recorded. Owned by the registry rather than the thread, so
+// the numbers outlive the short-lived pool workers; only the owning thread writes.
+// When a thread exits its entry is handed to the next new thread, which adds to it,
+// so --serve and --watch reloads do not grow the registry.
+struct ThreadStats {
+    int tid = 0;
+    uint64_t counters[STAT_COUNTER_COUNT] = {};
+    vector<StageTotal> stages;      // a handful of names, so a linear scan is fine
+    vector<TraceEvent> events;
+};
+
+static mutex registryMutex;
+static deque<ThreadStats> registry;
+static vector<ThreadStats*> freeStats;     // entries of threads that have exited
+static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+// a thread's claim on its registry entry, given back when the thread exits
+struct ThreadSlot {
+    ThreadStats* stats = nullptr;
+    ~ThreadSlot()
+    {
+        if (!stats) return;
+        lock_guard<mutex> lock(registryMutex);
+        freeStats.push_back(stats);
+    }
+};
+
+static ThreadStats& threadStats()
+{
+    static thread_local ThreadSlot mine;
+    if (!mine.stats) {
+        lock_guard<mutex> lock(registryMutex);
+        if (!freeStats.empty()) {
+            mine.stats = freeStats.back();
+            freeStats.pop_back();
+        }
+        else {
+            registry.emplace_back();
+            mine.stats = &registry.back();
+            mine.stats->tid = (int)registry.size();
+        }
+    }
+    return *mine.stats;
+}
+
+static int64_t nowNs()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+void statsStart(bool trace)
+{
+    statsActive = true;
+    traceActive = trace;
+    threadStats();  // the main thread gets track 1
+}
+
+void statsAddSlow(StatCounter c, uint64_t n)
+{
+    threadStats().counters[c] += n;
+}
+
+ScopedTimer::ScopedTimer(const char* scopeName)
+{
+    if (!statsActive) return;
+    name = scopeName;
+    start = nowNs();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (!name) return;
+    int64_t duration = nowNs() - start;
+    ThreadStats& t = threadStats();
+    StageTotal* stage = nullptr;
+    for (auto& s : t.stages) {
+        if (s.name == name) { stage = &s; break; }
+    }
+    if (!stage) {
+        t.stages.push_back(StageTotal{ name });
+        stage = &t.stages.back();
+    }
+    stage->calls++;
+    stage->totalNs += duration;
+    if (traceActive) t.events.push_back(TraceEvent{ name, start, duration });
+}
+
+void printStats(ostream& out)
+{
+    if (!statsActive) return;
+    lock_guard<mutex> lock(registryMutex);
+
+    // merge the per-thread stage totals, keeping first-seen order
+    vector<StageTotal> stages;
+    uint64_t counters[STAT_COUNTER_COUNT] = {};
+    for (auto& t : registry) {
+        for (int c = 0; c < STAT_COUNTER_COUNT; ++c) counters[c] += t.counters[c];
+        for (auto& s : t.stages) {
+            StageTotal* into = nullptr;
+            for (auto& m : stages) {
+                if (m.name == s.name) { into = &m; break; }
+            }
+            if (!into) {
+                stages.push_back(StageTotal{ s.name });
+                into = &stages.back();
+            }
+            into->calls += s.calls;
+            into->totalNs += s.totalNs;
+        }
+    }
+
+    out << "\nStats (" << registry.size() << " threads):\n";
+    out << left << setw(24) << "Stage" << right << setw(12) << "Calls" << setw(14) << "Total ms" << setw(14) << "Mean us" << "\n";
+    out << string(64, '-') << "\n";
+    for (auto& s : stages) {
+        double ms = (double)s.totalNs / 1e6;
+        double meanUs = s.calls ? (double)s.totalNs / 1e3 / (double)s.calls : 0.0;
+        out << left << setw(24) << s.name << right << setw(12) << s.calls
+            << setw(14) << fixed << setprecision(3) << ms << setw(14) << setprecision(2) << meanUs << "\n";
+    }
+    out << "\n" << left << setw(24) << "Counter" << right << setw(12) << "Value" << "\n";
+    out << string(36, '-') << "\n";
+    for (int c = 0; c < STAT_COUNTER_COUNT; ++c) {
+        out << left << setw(24) << COUNTER_NAMES[c] << right << setw(12) << counters[c] << "\n";
+    }
+    out << left;
+}
+
+static void writeJsonString(ostream& out, const char* s)
+{
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\';
+        out << *s;
+    }
+    out << '"';
+}
+
+bool writeTrace(const string& path)
+{
+    if (!traceActive) return false;
+    ofstream out(path);
+    if (!out.is_open()) return false;
+    lock_guard<mutex> lock(registryMutex);
+
+    // complete ("X") events in microseconds, plus a name for every thread track
+    char num[64];
+    bool first = true;
+    out << "{\"traceEvents\":[\n";
+    for (auto& t : registry) {
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t.tid
+            << ",\"args\":{\"name\":\"" << (t.tid == 1 ? "main" : "worker " + to_string(t.tid - 1)) << "\"}}";
+        for (auto& e : t.events) {
+            out << ",\n{\"name\":";
+            writeJsonString(out, e.name);
+            snprintf(num, sizeof(num), "%.3f", (double)e.startNs / 1e3);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << t.tid << ",\"ts\":" << num;
+            snprintf(num, sizeof(num), "%.3f", (double)e.durationNs / 1e3);
+            out << ",\"dur\":" << num << "}";
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return true;
+}
+
+#endif
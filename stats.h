@@ -0,0 +1,77 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+using namespace std;
+
+// Hot-path instrumentation: per-thread counters and scoped stage timers, printed by
+// --stats and exported by --trace as a Chrome trace-event file (chrome://tracing or
+// ui.perfetto.dev), one track per thread; the tracks of exited threads are reused.
+//
+// Build with RF_STATS=0 to compile it out: the RF_ macros below then expand to nothing
+// and the call sites cost nothing. When compiled in but not switched on at runtime,
+// each call site is one predictable branch on a global flag.
+#ifndef RF_STATS
+#define RF_STATS 1
+#endif
+
+enum StatCounter {
+    STAT_FILES_OPENED,
+    STAT_BYTES_READ,
+    STAT_NUMBER_SCANS,          // parseFirstNumber calls (the old GPA regex)
+    STAT_SKILL_COMPARISONS,     // candidate skill id looked up in a job skill set
+    STAT_POSTINGS_READ,         // keyword index postings visited (textindex.h)
+    STAT_IO_URING_ENTERS,       // io_uring_enter calls by the batched loader (fileloader.h)
+    STAT_GRADE_A,
+    STAT_GRADE_B,
+    STAT_GRADE_C,
+    STAT_GRADE_D,
+    STAT_COUNTER_COUNT
+};
+
+#if RF_STATS
+
+// set by statsStart() before any work starts, read unlocked by every thread
+extern bool statsActive;
+
+// turns collection on; with trace = true every timed scope is also kept as an event
+void statsStart(bool trace);
+
+void statsAddSlow(StatCounter c, uint64_t n);
+inline void statsAdd(StatCounter c, uint64_t n = 1)
+{
+    if (statsActive) statsAddSlow(c, n);
+}
+
+// Times the enclosing scope under `name`, which must be a string literal (names are
+// grouped by pointer). Nested scopes each count their full duration.
+struct ScopedTimer {
+    const char* name = nullptr;
+    int64_t start = 0;
+    explicit ScopedTimer(const char* scopeName);
+    ~ScopedTimer();
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+// Call once all workers have joined. Stage times are summed over threads, so a stage
+// that ran on four threads can show more time than the run took.
+void printStats(ostream& out);
+bool writeTrace(const string& path);
+
+#define RF_STAT_CONCAT2(a, b) a##b
+#define RF_STAT_CONCAT(a, b) RF_STAT_CONCAT2(a, b)
+#define RF_STAT_ADD(counter, n) statsAdd(counter, n)
+#define RF_TIMED_SCOPE(name) ScopedTimer RF_STAT_CONCAT(rfTimer, __LINE__)(name)
+
+#else
+
+#define RF_STAT_ADD(counter, n) ((void)0)
+#define RF_TIMED_SCOPE(name) ((void)0)
+
+#endif
+
+#endif // STATS_H
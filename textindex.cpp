@@ -0,0 +1,255 @@
+#include "textindex.h"
+#include "stats.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+static const double BM25_K1 = 1.2;
+static const double BM25_B = 0.75;
+
+static inline bool isWordByte(unsigned char ch)
+{
+    return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+// calls f(hash) for every word of text: FNV-1a over the lowercased bytes
+template <class F>
+static void forEachWord(string_view text, F&& f)
+{
+    size_t i = 0;
+    while (i < text.size()) {
+        if (!isWordByte((unsigned char)text[i])) { i++; continue; }
+        uint64_t h = 14695981039346656037ull;
+        for (; i < text.size() && isWordByte((unsigned char)text[i]); ++i) {
+            unsigned char ch = (unsigned char)text[i];
+            if (ch >= 'A' && ch <= 'Z') ch = (unsigned char)(ch - 'A' + 'a');
+            h = (h ^ ch) * 1099511628211ull;
+        }
+        f(h);
+    }
+}
+
+void addDocument(TextIndex& index, string_view text)
+{
+    const uint32_t doc = (uint32_t)index.own.docLength.size();
+    static thread_local vector<uint64_t> words;
+    words.clear();
+    forEachWord(text, [&](uint64_t h) { words.push_back(h); });
+    index.own.docLength.push_back((uint32_t)words.size());
+    index.docLength = columnOf(index.own.docLength);
+
+    // equal words are adjacent once sorted: one entry per distinct word
+    sort(words.begin(), words.end());
+    for (size_t i = 0; i < words.size();) {
+        size_t end = i + 1;
+        while (end < words.size() && words[end] == words[i]) end++;
+        auto it = index.pendingIds.emplace(words[i], (uint32_t)index.pendingIds.size()).first;
+        index.pendingTerms.push_back(it->second);
+        index.pendingDocs.push_back(doc);
+        index.pendingCounts.push_back((uint32_t)(end - i));
+        i = end;
+    }
+}
+
+// points the columns at the index's own storage
+static void bindOwnColumns(TextIndex& index)
+{
+    TextIndex::Storage& s = index.own;
+    index.termWords = columnOf(s.termWords);
+    index.postingStart = columnOf(s.postingStart);
+    index.postingDocs = columnOf(s.postingDocs);
+    index.postingCounts = columnOf(s.postingCounts);
+    index.docLength = columnOf(s.docLength);
+    index.lengthNorm = columnOf(s.lengthNorm);
+}
+
+void finishTextIndex(TextIndex& index)
+{
+    TextIndex::Storage& s = index.own;
+    // final term ids follow word hash order, so the term table is a sorted array that
+    // a mapped index can search as is
+    const size_t termCount = index.pendingIds.size();
+    vector<pair<uint64_t, uint32_t>> byWord(index.pendingIds.begin(), index.pendingIds.end());
+    sort(byWord.begin(), byWord.end());
+    vector<uint32_t> finalId(termCount);
+    s.termWords.resize(termCount);
+    for (size_t t = 0; t < termCount; ++t) {
+        s.termWords[t] = byWord[t].first;
+        finalId[byWord[t].second] = (uint32_t)t;
+    }
+    index.pendingIds = unordered_map<uint64_t, uint32_t>();
+
+    // counting sort by term; documents were added in order, so each term's postings
+    // come out ascending
+    const size_t n = index.pendingTerms.size();
+    s.postingStart.assign(termCount + 1, 0);
+    for (uint32_t& t : index.pendingTerms) {
+        t = finalId[t];
+        s.postingStart[t + 1]++;
+    }
+    for (size_t t = 0; t < termCount; ++t) s.postingStart[t + 1] += s.postingStart[t];
+    s.postingDocs.resize(n);
+    s.postingCounts.resize(n);
+    vector<uint32_t> next(s.postingStart.begin(), s.postingStart.end() - 1);
+    for (size_t k = 0; k < n; ++k) {
+        const uint32_t at = next[index.pendingTerms[k]]++;
+        s.postingDocs[at] = index.pendingDocs[k];
+        s.postingCounts[at] = index.pendingCounts[k];
+    }
+    index.pendingTerms = vector<uint32_t>();
+    index.pendingDocs = vector<uint32_t>();
+    index.pendingCounts = vector<uint32_t>();
+
+    double total = 0.0;
+    for (uint32_t len : s.docLength) total += len;
+    const double average = s.docLength.empty() ? 0.0 : total / (double)s.docLength.size();
+    s.lengthNorm.resize(s.docLength.size());
+    for (size_t d = 0; d < s.docLength.size(); ++d) {
+        const double ratio = average > 0.0 ? s.docLength[d] / average : 1.0;
+        s.lengthNorm[d] = BM25_K1 * (1.0 - BM25_B + BM25_B * ratio);
+    }
+    bindOwnColumns(index);
+}
+
+bool viewTextIndex(TextIndex& index, Column<uint64_t> termWords, Column<uint32_t> postingStart,
+                   Column<uint32_t> postingDocs, Column<uint32_t> postingCounts,
+                   Column<uint32_t> docLength, Column<double> lengthNorm)
+{
+    // everything a query dereferences is checked once here, so scoring a corrupt file
+    // gives wrong relevance at worst, never a stray read or write
+    const size_t n = docLength.size();
+    if (lengthNorm.size() != n || postingStart.size() != termWords.size() + 1 || postingStart[0] != 0
+        || postingStart[termWords.size()] != postingDocs.size() || postingCounts.size() != postingDocs.size()) {
+        return false;
+    }
+    for (size_t t = 0; t < termWords.size(); ++t) {
+        if (t > 0 && termWords[t] <= termWords[t - 1]) return false;
+        if (postingStart[t + 1] < postingStart[t] || postingStart[t + 1] > postingDocs.size()) return false;
+        uint32_t last = 0;
+        for (uint32_t p = postingStart[t]; p < postingStart[t + 1]; ++p) {
+            const uint32_t d = postingDocs[p];
+            if (d >= n || (p > postingStart[t] && d <= last)) return false;
+            last = d;
+        }
+    }
+    index.own = TextIndex::Storage();
+    index.pendingIds = unordered_map<uint64_t, uint32_t>();
+    index.termWords = termWords;
+    index.postingStart = postingStart;
+    index.postingDocs = postingDocs;
+    index.postingCounts = postingCounts;
+    index.docLength = docLength;
+    index.lengthNorm = lengthNorm;
+    return true;
+}
+
+void prepareKeywordQuery(KeywordQuery& q, const vector<string>& keywords)
+{
+    q.words.clear();
+    for (auto& kw : keywords) forEachWord(kw, [&](uint64_t h) { q.words.push_back(h); });
+    sort(q.words.begin(), q.words.end());
+    q.words.erase(unique(q.words.begin(), q.words.end()), q.words.end());
+    q.terms.clear();
+    q.weights.clear();
+}
+
+void bindKeywordQuery(KeywordQuery& q, const TextIndex& index)
+{
+    q.terms.clear();
+    q.weights.clear();
+    const double n = (double)documentCount(index);
+    double total = 0.0;
+    for (uint64_t w : q.words) {
+        auto it = lower_bound(index.termWords.begin(), index.termWords.end(), w);
+        if (it == index.termWords.end() || *it != w) continue;
+        const uint32_t t = (uint32_t)(it - index.termWords.begin());
+        const double df = (double)(index.postingStart[t + 1] - index.postingStart[t]);
+        const double idf = log(1.0 + (n - df + 0.5) / (df + 0.5));
+        q.terms.push_back(t);
+        q.weights.push_back(idf);
+        total += idf;
+    }
+    // idf * (k1 + 1) is a term's limit as its count grows; scaled by the sum of those
+    // limits, the (k1 + 1) cancels
+    for (double& w : q.weights) w = total > 0.0 ? w / total : 0.0;
+}
+
+size_t postingCount(const TextIndex& index, const KeywordQuery& q)
+{
+    size_t total = 0;
+    for (uint32_t t : q.terms) total += index.postingStart[t + 1] - index.postingStart[t];
+    return total;
+}
+
+// one posting's share of a document's relevance
+static inline double termRelevance(double weight, uint32_t count, double lengthNorm)
+{
+    return weight * ((double)count / ((double)count + lengthNorm));
+}
+
+void scoreAllDocuments(const TextIndex& index, const KeywordQuery& q, double* out)
+{
+    const size_t n = documentCount(index);
+    fill(out, out + n, 0.0);
+    for (size_t k = 0; k < q.terms.size(); ++k) {
+        const uint32_t t = q.terms[k];
+        const double weight = q.weights[k];
+        RF_STAT_ADD(STAT_POSTINGS_READ, index.postingStart[t + 1] - index.postingStart[t]);
+        for (uint32_t p = index.postingStart[t]; p < index.postingStart[t + 1]; ++p) {
+            const uint32_t d = index.postingDocs[p];
+            out[d] += termRelevance(weight, index.postingCounts[p], index.lengthNorm[d]);
+        }
+    }
+    // rounding can carry a perfect match a hair past 1
+    for (size_t d = 0; d < n; ++d) out[d] = min(out[d], 1.0);
+}
+
+// first position in [from, end) whose document is >= doc: doubling steps, then a
+// binary search within the last step
+static inline uint32_t skipTo(const uint32_t* docs, uint32_t from, uint32_t end, uint32_t doc)
+{
+    uint32_t step = 1, lo = from;
+    while (lo + step < end && docs[lo + step] < doc) {
+        lo += step;
+        step *= 2;
+    }
+    const uint32_t hi = min(end, lo + step + 1);
+    return (uint32_t)(lower_bound(docs + lo, docs + hi, doc) - docs);
+}
+
+void scoreDocuments(const TextIndex& index, const KeywordQuery& q, const uint32_t* docs, size_t count, double* out)
+{
+    fill(out, out + count, 0.0);
+    for (size_t k = 0; k < q.terms.size(); ++k) {
+        const uint32_t t = q.terms[k];
+        const double weight = q.weights[k];
+        uint32_t p = index.postingStart[t];
+        const uint32_t end = index.postingStart[t + 1];
+        uint32_t probes = 0;
+        for (size_t j = 0; j < count && p < end; ++j) {
+            p = skipTo(index.postingDocs.data(), p, end, docs[j]);
+            probes++;
+            if (p < end && index.postingDocs[p] == docs[j]) out[j] += termRelevance(weight, index.postingCounts[p], index.lengthNorm[docs[j]]);
+        }
+        RF_STAT_ADD(STAT_POSTINGS_READ, probes);
+    }
+    for (size_t j = 0; j < count; ++j) out[j] = min(out[j], 1.0);
+}
+
+double scoreStandalone(const KeywordQuery& q, string_view text)
+{
+    if (q.words.empty()) return 0.0;
+    static thread_local vector<uint32_t> counts;
+    counts.assign(q.words.size(), 0);
+    forEachWord(text, [&](uint64_t h) {
+        auto it = lower_bound(q.words.begin(), q.words.end(), h);
+        if (it != q.words.end() && *it == h) counts[it - q.words.begin()]++;
+    });
+    const double weight = 1.0 / (double)q.words.size();
+    double relevance = 0.0;
+    for (uint32_t c : counts) {
+        if (c > 0) relevance += termRelevance(weight, c, BM25_K1);
+    }
+    return min(relevance, 1.0);
+}
@@ -0,0 +1,92 @@
+#ifndef TEXTINDEX_H
+#define TEXTINDEX_H
+
+#include "column.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Inverted index over resume text for BM25 keyword relevance. Words are runs of ASCII
+// letters and digits, compared case-insensitively and keyed by a 64-bit hash of the
+// lowercased word. Each term's postings list the documents that contain it, in
+// ascending order, with the number of times it occurs there; a query only reads the
+// postings of its own terms.
+// The columns are read-only views: of `own` for an index built here, or of a mapped
+// snapshot for one loaded from disk. Not copyable, since a copy's columns would
+// still point at the original's storage.
+struct TextIndex {
+    Column<uint64_t> termWords;         // word hash of term t, ascending: term ids follow hash order
+    Column<uint32_t> postingStart;      // term t: [postingStart[t], postingStart[t + 1])
+    Column<uint32_t> postingDocs;
+    Column<uint32_t> postingCounts;
+    Column<uint32_t> docLength;         // words per document
+    Column<double> lengthNorm;          // per document: k1 * (1 - b + b * length / average)
+
+    // storage behind the columns of a built index
+    struct Storage {
+        vector<uint64_t> termWords;
+        vector<uint32_t> postingStart = { 0 };
+        vector<uint32_t> postingDocs;
+        vector<uint32_t> postingCounts;
+        vector<uint32_t> docLength;
+        vector<double> lengthNorm;
+    } own;
+
+    // provisional term ids by word hash, and (term, document, count) per distinct
+    // word, collected until finishTextIndex
+    unordered_map<uint64_t, uint32_t> pendingIds;
+    vector<uint32_t> pendingTerms, pendingDocs, pendingCounts;
+
+    TextIndex() = default;
+    TextIndex(TextIndex&&) = default;
+    TextIndex& operator=(TextIndex&&) = default;
+    TextIndex(const TextIndex&) = delete;
+    TextIndex& operator=(const TextIndex&) = delete;
+};
+
+inline size_t documentCount(const TextIndex& index) { return index.docLength.size(); }
+
+// indexes text as the next document; ids are 0, 1, 2, ... in the order added
+void addDocument(TextIndex& index, string_view text);
+// builds the postings once the last document has been added
+void finishTextIndex(TextIndex& index);
+// Points the index at postings stored elsewhere (a mapped snapshot), which must stay
+// alive as long as the index; the columns must hold one finished index. false if
+// they do not fit together (sizes, term order, document ids in range and ascending).
+bool viewTextIndex(TextIndex& index, Column<uint64_t> termWords, Column<uint32_t> postingStart,
+                   Column<uint32_t> postingDocs, Column<uint32_t> postingCounts,
+                   Column<uint32_t> docLength, Column<double> lengthNorm);
+
+// The distinct words of a job's keywords. Bound to an index, each term the index
+// knows gets its BM25 weight (k1 = 1.2, b = 0.75, idf never negative), scaled so that
+// a document's relevance is in [0, 1]. Query words no document contains get no
+// weight, since they cannot tell documents apart.
+struct KeywordQuery {
+    vector<uint64_t> words;     // word hashes, sorted
+    vector<uint32_t> terms;     // bound: term ids of the words the index knows
+    vector<double> weights;     // bound: the most each term can add to a relevance
+};
+
+void prepareKeywordQuery(KeywordQuery& q, const vector<string>& keywords);
+void bindKeywordQuery(KeywordQuery& q, const TextIndex& index);
+// total length of the bound query's postings: what scoreAllDocuments reads
+size_t postingCount(const TextIndex& index, const KeywordQuery& q);
+
+// relevance of every document into out[0 .. documentCount), term at a time
+void scoreAllDocuments(const TextIndex& index, const KeywordQuery& q, double* out);
+// Relevance of the listed documents only (ascending ids), bit-identical to
+// scoreAllDocuments. Each term's postings are skipped through by galloping search, so
+// a few documents cost far less than the whole postings.
+void scoreDocuments(const TextIndex& index, const KeywordQuery& q, const uint32_t* docs, size_t count, double* out);
+// Relevance of one text without an index (streaming, where the other documents are
+// not known yet): every query word weighs the same and the text counts as average
+// length. Not comparable with indexed relevance.
+double scoreStandalone(const KeywordQuery& q, string_view text);
+
+#endif // TEXTINDEX_H
@@ -0,0 +1,87 @@
+#include "threadpool.h"
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// a worker's share of the index range: the owner pops from the front,
+// thieves take from the back
+struct WorkRange {
+    mutex m;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+int defaultThreadCount()
+{
+    unsigned n = thread::hardware_concurrency();
+    return n == 0 ? 1 : (int)n;
+}
+
+static bool popFront(WorkRange& r, size_t& out)
+{
+    lock_guard<mutex> lock(r.m);
+    if (r.begin >= r.end) return false;
+    out = r.begin++;
+    return true;
+}
+
+static bool stealBack(WorkRange& r, size_t& out)
+{
+    lock_guard<mutex> lock(r.m);
+    if (r.begin >= r.end) return false;
+    out = --r.end;
+    return true;
+}
+
+void parallelFor(size_t count, int threads, const function<void(size_t index, int worker)>& task)
+{
+    if (count == 0) return;
+    if (threads <= 1 || count == 1) {
+        for (size_t i = 0; i < count; ++i) task(i, 0);
+        return;
+    }
+    if ((size_t)threads > count) threads = (int)count;
+
+    vector<WorkRange> ranges(threads);
+    size_t chunk = count / threads;
+    size_t extra = count % threads;
+    size_t pos = 0;
+    for (int w = 0; w < threads; ++w) {
+        ranges[w].begin = pos;
+        pos += chunk + ((size_t)w < extra ? 1 : 0);
+        ranges[w].end = pos;
+    }
+
+    mutex errorMutex;
+    exception_ptr firstError;
+
+    auto worker = [&](int self) {
+        size_t index = 0;
+        for (;;) {
+            bool found = popFront(ranges[self], index);
+            // own range is empty: try every other worker, starting with the next one
+            for (int k = 1; !found && k < threads; ++k) {
+                found = stealBack(ranges[(self + k) % threads], index);
+            }
+            // nothing adds work once we start, so an empty sweep means we are done
+            if (!found) return;
+            try {
+                task(index, self);
+            }
+            catch (...) {
+                lock_guard<mutex> lock(errorMutex);
+                if (!firstError) firstError = current_exception();
+            }
+        }
+    };
+
+    vector<thread> pool;
+    for (int w = 1; w < threads; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (auto& t : pool) t.join();
+
+    if (firstError) rethrow_exception(firstError);
+}
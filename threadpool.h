@@ -0,0 +1,20 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+using namespace std;
+
+// number of workers to use when the user asks for "all cores" (--threads 0)
+int defaultThreadCount();
+
+// Runs task(index, worker) once for every index in [0, count) using `threads` workers.
+// Each worker starts with its own contiguous block of indices and, once that runs dry,
+// steals from the back of the other workers' blocks, so a few slow items cannot leave
+// the rest of the pool idle. With threads <= 1 everything runs on the calling thread.
+// If a task throws, the remaining indices still run and the first exception is
+// rethrown after all workers have joined.
+void parallelFor(size_t count, int threads, const function<void(size_t index, int worker)>& task);
+
+#endif // THREADPOOL_H
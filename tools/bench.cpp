@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "corpus.h"
+#include "../parser.h"
+#include "../scorer.h"
+#include "../report.h"
+#include "../threadpool.h"
+#include "../utils.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// bench: micro and end-to-end benchmarks of the parser, scorer and report writer over
+// a synthetic corpus (see README, "Benchmarks"). Results go to the console and to a
+// JSON file so runs can be compared.
+
+struct BenchOptions {
+    string corpusDir;           // existing corpus_gen output; generated into a temp dir if empty
+    CorpusOptions corpus;
+    int iterations = 5;
+    int threads = 1;            // parser threads for the end-to-end run
+    string outPath = "bench_results.json";
+    string label;
+};
+
+struct BenchResult {
+    string name;
+    uint64_t items = 0;         // resumes, lines or candidate-job pairs per iteration
+    uint64_t bytes = 0;         // input bytes per iteration (0 if not meaningful)
+    int iterations = 0;
+    double bestSeconds = 0.0;
+    double medianSeconds = 0.0;
+};
+
+// keeps the optimizer from dropping the work being timed
+static volatile uint64_t benchSink = 0;
+
+static BenchResult runBench(const string& name, uint64_t items, uint64_t bytes, int iterations, const function<void()>& body)
+{
+    BenchResult r;
+    r.name = name;
+    r.items = items;
+    r.bytes = bytes;
+    r.iterations = iterations;
+    vector<double> times;
+    for (int it = 0; it < iterations; ++it) {
+        auto start = chrono::steady_clock::now();
+        body();
+        times.push_back(chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    sort(times.begin(), times.end());
+    r.bestSeconds = times.front();
+    r.medianSeconds = times[times.size() / 2];
+    return r;
+}
+
+static double perSecond(uint64_t n, double seconds)
+{
+    return seconds > 0.0 ? (double)n / seconds : 0.0;
+}
+
+static vector<string> listTxt(const string& folder)
+{
+    vector<string> out;
+    error_code ec;
+    for (auto& ent : fs::directory_iterator(folder, ec)) {
+        if (ent.is_regular_file() && ent.path().extension() == ".txt") out.push_back(ent.path().string());
+    }
+    sort(out.begin(), out.end());
+    return out;
+}
+
+static bool readAll(const string& path, string& out)
+{
+    ifstream in(path, ios::binary);
+    if (!in.is_open()) return false;
+    out.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    return true;
+}
+
+static string jsonString(const string& s)
+{
+    string out;
+    appendJsonString(out, s);
+    return out;
+}
+
+static bool writeJson(const string& path, const BenchOptions& o, size_t resumes, uint64_t corpusBytes, const vector<BenchResult>& results)
+{
+    ofstream out(path);
+    if (!out.is_open()) return false;
+    char num[64];
+    out << "{\n";
+    out << "  \"label\": " << jsonString(o.label) << ",\n";
+    out << "  \"resumes\": " << resumes << ",\n";
+    out << "  \"corpus_bytes\": " << corpusBytes << ",\n";
+    out << "  \"seed\": " << o.corpus.seed << ",\n";
+    out << "  \"threads\": " << o.threads << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": " << jsonString(r.name)
+            << ", \"items\": " << r.items
+            << ", \"bytes\": " << r.bytes
+            << ", \"iterations\": " << r.iterations;
+        snprintf(num, sizeof(num), "%.9f", r.bestSeconds);
+        out << ", \"best_seconds\": " << num;
+        snprintf(num, sizeof(num), "%.9f", r.medianSeconds);
+        out << ", \"median_seconds\": " << num;
+        snprintf(num, sizeof(num), "%.1f", perSecond(r.items, r.bestSeconds));
+        out << ", \"items_per_sec\": " << num;
+        snprintf(num, sizeof(num), "%.3f", perSecond(r.bytes, r.bestSeconds) / 1e6);
+        out << ", \"mb_per_sec\": " << num << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+static void printUsage()
+{
+    cout << "Usage: bench [options]\n";
+    cout << "  --corpus DIR       use an existing corpus_gen output instead of generating one\n";
+    cout << "  --resumes N        resumes to generate (default 1000)\n";
+    cout << "  --seed S           corpus seed (default 1)\n";
+    cout << "  --iterations N     timed runs per benchmark; best and median are reported (default 5)\n";
+    cout << "  --threads N        parser threads for the end-to-end run (0 = all cores, default 1)\n";
+    cout << "  --out FILE         JSON results file (default bench_results.json)\n";
+    cout << "  --label TEXT       free-form label stored with the results (build flags, commit, ...)\n";
+}
+
+static bool parseArgs(int argc, char* argv[], BenchOptions& o)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        uint64_t n = 0;
+        if (arg == "--corpus" && hasValue) o.corpusDir = argv[++i];
+        else if (arg == "--resumes" && hasValue) {
+            if (!parseUnsigned(argv[++i], SIZE_MAX, n)) return false;
+            o.corpus.resumes = (size_t)n;
+        }
+        else if (arg == "--seed" && hasValue) {
+            if (!parseUnsigned(argv[++i], UINT64_MAX, o.corpus.seed)) return false;
+        }
+        else if (arg == "--iterations" && hasValue) {
+            if (!parseUnsigned(argv[++i], INT_MAX, n)) return false;
+            o.iterations = (int)n;
+        }
+        else if (arg == "--threads" && hasValue) {
+            if (!parseUnsigned(argv[++i], INT_MAX, n)) return false;
+            o.threads = n == 0 ? defaultThreadCount() : (int)n;
+        }
+        else if (arg == "--out" && hasValue) o.outPath = argv[++i];
+        else if (arg == "--label" && hasValue) o.label = argv[++i];
+        else return false;
+    }
+    return o.iterations > 0;
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions o;
+    if (!parseArgs(argc, argv, o)) {
+        printUsage();
+        return 1;
+    }
+
+    string dir = o.corpusDir;
+    if (dir.empty()) {
+        dir = (fs::temp_directory_path() / ("resume_filter_bench_" + to_string(o.corpus.seed))).string();
+        error_code ec;
+        fs::remove_all(dir, ec);
+        if (writeCorpus(dir + "/resumes", dir + "/jobs", o.corpus) == 0) return 1;
+    }
+    const string resumeDir = dir + "/resumes";
+    vector<string> paths = listTxt(resumeDir);
+    vector<string> jobPaths = listTxt(dir + "/jobs");
+    if (paths.empty() || jobPaths.empty()) {
+        cout << "No resumes or jobs found under: " << dir << "\n";
+        return 1;
+    }
+
+    // raw text for the byte counts and the line-level benchmark
+    uint64_t corpusBytes = 0;
+    vector<string> lines;
+    uint64_t lineBytes = 0;
+    for (auto& p : paths) {
+        string text;
+        if (!readAll(p, text)) continue;
+        corpusBytes += text.size();
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            if (nl == string::npos) nl = text.size();
+            lines.push_back(text.substr(pos, nl - pos));
+            lineBytes += nl - pos;
+            pos = nl + 1;
+        }
+    }
+
+    vector<Job> jobs;
+    for (auto& p : jobPaths) jobs.push_back(parseJobDescription(p));
+    vector<Candidate> candidates;
+    for (auto& p : paths) candidates.push_back(parseResumeFile(p));
+
+    vector<BenchResult> results;
+
+    results.push_back(runBench("parse_resume_file", paths.size(), corpusBytes, o.iterations, [&] {
+        uint64_t n = 0;
+        for (auto& p : paths) n += parseResumeFile(p).skills.size();
+        benchSink = benchSink + n;
+    }));
+
+    results.push_back(runBench("parse_first_number", lines.size(), lineBytes, o.iterations, [&] {
+        double sum = 0.0;
+        for (auto& ln : lines) {
+            double v = 0.0;
+            if (parseFirstNumber(ln, v)) sum += v;
+        }
+        benchSink = benchSink + (uint64_t)sum;
+    }));
+
+    // candidate skills against the job's required / preferred bitsets
+    results.push_back(runBench("skill_match", (uint64_t)candidates.size() * jobs.size(), 0, o.iterations, [&] {
+        uint64_t n = 0;
+        for (auto& job : jobs) {
+            for (auto& c : candidates) {
+                for (uint32_t s : c.skills) n += hasSkill(job.requiredSkills, s) + hasSkill(job.preferredSkills, s);
+            }
+        }
+        benchSink = benchSink + n;
+    }));
+
+    results.push_back(runBench("score_all_candidates", (uint64_t)candidates.size() * jobs.size(), 0, o.iterations, [&] {
+        for (auto& job : jobs) scoreAllCandidates(candidates, job, o.threads);
+        benchSink = benchSink + (uint64_t)candidates[0].score;
+    }));
+
+    const string reportPath = (fs::temp_directory_path() / "resume_filter_bench_report.txt").string();
+    scoreAllCandidates(candidates, jobs[0]);
+    results.push_back(runBench("write_report", candidates.size(), 0, o.iterations, [&] {
+        writeReport(reportPath, candidates, jobs[0]);
+    }));
+
+    results.push_back(runBench("end_to_end", paths.size(), corpusBytes, o.iterations, [&] {
+        IngestOptions ingest;
+        ingest.threads = o.threads;
+        vector<Candidate> pool = parseResumesFromFolder(resumeDir, ingest);
+        scoreAllCandidates(pool, jobs[0], o.threads);
+        writeReport(reportPath, pool, jobs[0]);
+    }));
+
+    error_code ec;
+    fs::remove(reportPath, ec);
+
+    printf("\n%-22s %12s %12s %14s %10s\n", "benchmark", "best ms", "median ms", "items/sec", "MB/sec");
+    printf("%s\n", string(74, '-').c_str());
+    for (auto& r : results) {
+        printf("%-22s %12.3f %12.3f %14.0f %10.2f\n", r.name.c_str(), r.bestSeconds * 1e3, r.medianSeconds * 1e3,
+            perSecond(r.items, r.bestSeconds), perSecond(r.bytes, r.bestSeconds) / 1e6);
+    }
+
+    if (!writeJson(o.outPath, o, paths.size(), corpusBytes, results)) {
+        cout << "\nFailed to write " << o.outPath << "\n";
+        return 1;
+    }
+    cout << "\nResults written to: " << o.outPath << "\n";
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include "corpus.h"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Own generator and distributions instead of <random>'s: the standard distributions
+// differ between MSVC and libstdc++, which would make corpora non-reproducible.
+struct Rng {
+    uint64_t state;
+};
+
+static uint64_t nextRandom(Rng& r)
+{
+    // splitmix64
+    uint64_t z = (r.state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double unitRandom(Rng& r)
+{
+    return (double)(nextRandom(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static int rangeRandom(Rng& r, int lo, int hi)
+{
+    if (hi <= lo) return lo;
+    return lo + (int)(nextRandom(r) % (uint64_t)(hi - lo + 1));
+}
+
+static bool chance(Rng& r, double p)
+{
+    return unitRandom(r) < p;
+}
+
+// mix of canonical names, aliases ("cpp", "js") and spellings that need normalizing
+static const vector<string> SKILLS = {
+    "C++", "Python", "SQL", "Java", "JavaScript", "Git", "Linux", "algorithms", "data structures",
+    "HTML", "CSS", "machine learning", "cpp", "js", "Docker", "Kubernetes", "AWS", "Go", "Rust",
+    "TypeScript", "React", "Node.js", "Bash", "PostgreSQL", "MongoDB", "Pandas", "NumPy",
+    "TensorFlow", "PyTorch", "Spark", "Kafka", "Terraform", "C#", "Kotlin", "Swift", "Scala",
+    "REST", "GraphQL", "Redis", "ML",
+};
+
+static const vector<string> CERTS = {
+    "AWS Certified Solutions Architect", "Oracle Certified Professional", "CCNA", "PMP",
+    "Azure Fundamentals", "OCJP", "Google Cloud Associate", "CKA",
+};
+
+static const vector<string> FIRST_NAMES = {
+    "Alice", "John", "Maria", "Wei", "Fatima", "Olusegun", "Priya", "Lars", "Ana", "Kenji",
+    "Sara", "Omar", "Elena", "David", "Aisha", "Mateo",
+};
+
+static const vector<string> LAST_NAMES = {
+    "Johnson", "Smith", "Gomez", "Zhang", "Khan", "Adeyemi", "Patel", "Nilsson", "Silva", "Sato",
+    "Cohen", "Haddad", "Petrova", "Brown", "Bello", "Rossi",
+};
+
+static const vector<string> DEGREES = {
+    "B.Sc. Computer Science", "BS Information Technology", "B.Eng. Software Engineering",
+    "M.Sc. Data Science", "BA Mathematics", "MS Computer Engineering",
+};
+
+static const vector<string> COMPANIES = {
+    "ExampleCorp", "WebCo", "DataInc", "StartUp", "CloudWorks", "FinSoft", "NetSystems", "Medix",
+};
+
+static const vector<string> FILLER = {
+    "Worked on backend services and internal tooling for a growing team.",
+    "Comfortable with code review, testing and continuous integration.",
+    "Enjoys profiling and optimizing slow code paths.",
+    "Led a small team through two product launches.",
+    "Contributed to open source projects in spare time.",
+    "Strong communication skills and a focus on clear documentation.",
+};
+
+template <class T>
+static const T& pick(Rng& r, const vector<T>& v)
+{
+    return v[nextRandom(r) % v.size()];
+}
+
+// cumulative Zipf weights over SKILLS
+static vector<double> skillWeights(double skew)
+{
+    vector<double> cum(SKILLS.size());
+    double total = 0.0;
+    for (size_t i = 0; i < SKILLS.size(); ++i) {
+        total += 1.0 / pow((double)(i + 1), skew);
+        cum[i] = total;
+    }
+    for (auto& w : cum) w /= total;
+    return cum;
+}
+
+static size_t pickWeighted(Rng& r, const vector<double>& cum)
+{
+    double u = unitRandom(r);
+    for (size_t i = 0; i < cum.size(); ++i) if (u < cum[i]) return i;
+    return cum.size() - 1;
+}
+
+// n distinct skills drawn by weight
+static vector<size_t> drawSkills(Rng& r, const vector<double>& cum, int n)
+{
+    vector<size_t> out;
+    if (n > (int)SKILLS.size()) n = (int)SKILLS.size();
+    while ((int)out.size() < n) {
+        size_t s = pickWeighted(r, cum);
+        bool dup = false;
+        for (auto x : out) if (x == s) { dup = true; break; }
+        if (!dup) out.push_back(s);
+    }
+    return out;
+}
+
+static string joinSkills(const vector<size_t>& ids, const char* sep)
+{
+    string out;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i) out += sep;
+        out += SKILLS[ids[i]];
+    }
+    return out;
+}
+
+static string fixed1(double v)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f", v);
+    return buf;
+}
+
+static string makeResume(Rng& r, const CorpusOptions& o, const vector<double>& cum)
+{
+    string t;
+    string name = pick(r, FIRST_NAMES) + " " + pick(r, LAST_NAMES);
+    if (chance(r, o.noNameLine)) t += name + "\n";
+    else t += "Name: " + name + "\n";
+    t += "Education: " + pick(r, DEGREES) + "\n";
+
+    if (!chance(r, o.gpaMissing)) {
+        if (chance(r, o.gpaOutOfTen)) t += "CGPA: " + fixed1(rangeRandom(r, 50, 100) / 10.0) + "/10\n";
+        else t += "GPA: " + fixed1(rangeRandom(r, 20, 40) / 10.0) + "\n";
+    }
+
+    vector<size_t> skills = drawSkills(r, cum, rangeRandom(r, o.minSkills, o.maxSkills));
+    if (chance(r, o.noSkillsLine)) t += "Summary: experienced with " + joinSkills(skills, " and ") + ".\n";
+    else t += "Skills: " + joinSkills(skills, ", ") + "\n";
+
+    int clauses = rangeRandom(r, 1, o.maxExperienceLines < 1 ? 1 : o.maxExperienceLines);
+    t += "Experience: ";
+    for (int k = 0; k < clauses; ++k) {
+        if (k) t += "; ";
+        int years = rangeRandom(r, 1, 6);
+        t += to_string(years) + (years == 1 ? " year at " : " years at ") + pick(r, COMPANIES);
+    }
+    t += "\n";
+
+    string certs;
+    for (int k = 0; k < 2; ++k) {
+        if (!chance(r, o.certProbability)) continue;
+        if (!certs.empty()) certs += ", ";
+        certs += pick(r, CERTS);
+    }
+    t += "Certifications: " + (certs.empty() ? string("None") : certs) + "\n";
+
+    for (int k = 0; k < o.fillerLines; ++k) t += pick(r, FILLER) + "\n";
+    return t;
+}
+
+static string makeJob(Rng& r, const vector<double>& cum, size_t index)
+{
+    vector<size_t> skills = drawSkills(r, cum, 5);
+    vector<size_t> req(skills.begin(), skills.begin() + 3);
+    vector<size_t> pref(skills.begin() + 3, skills.end());
+    string t;
+    t += "Job Title: Synthetic Role " + to_string(index) + "\n";
+    t += "Required Skills: " + joinSkills(req, ", ") + "\n";
+    t += "Preferred Skills: " + joinSkills(pref, ", ") + "\n";
+    t += "Min GPA: " + fixed1(rangeRandom(r, 25, 35) / 10.0) + "\n";
+    t += "Min Experience: " + to_string(rangeRandom(r, 1, 5)) + "\n";
+    t += "Required Certifications: " + pick(r, CERTS) + "\n";
+    t += "Description: Looking for a candidate with " + SKILLS[req[0]] + " and " + SKILLS[pref[0]] + " experience.\n";
+    return t;
+}
+
+static bool writeFile(const fs::path& path, const string& content, uint64_t& bytes)
+{
+    ofstream out(path, ios::binary);
+    if (!out.is_open()) {
+        cout << "Cannot write file: " << path.string() << "\n";
+        return false;
+    }
+    out << content;
+    bytes += content.size();
+    return true;
+}
+
+uint64_t writeCorpus(const string& resumeFolder, const string& jobFolder, const CorpusOptions& options)
+{
+    error_code ec;
+    fs::create_directories(resumeFolder, ec);
+    fs::create_directories(jobFolder, ec);
+
+    Rng r{ options.seed };
+    const vector<double> cum = skillWeights(options.skillSkew);
+    uint64_t bytes = 0;
+    char name[32];
+    for (size_t i = 0; i < options.resumes; ++i) {
+        snprintf(name, sizeof(name), "resume_%06zu.txt", i);
+        if (!writeFile(fs::path(resumeFolder) / name, makeResume(r, options, cum), bytes)) return 0;
+    }
+    for (size_t j = 0; j < options.jobs; ++j) {
+        snprintf(name, sizeof(name), "job_%02zu.txt", j);
+        if (!writeFile(fs::path(jobFolder) / name, makeJob(r, cum, j), bytes)) return 0;
+    }
+    return bytes;
+}
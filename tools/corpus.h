@@ -0,0 +1,34 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Shape of a synthetic resume corpus. Fractions are 0..1 and apply per resume.
+// The same options and seed always give byte-identical files on every platform.
+struct CorpusOptions {
+    size_t resumes = 1000;
+    size_t jobs = 4;
+    uint64_t seed = 1;
+
+    int minSkills = 3;              // skills listed on the "Skills:" line
+    int maxSkills = 10;
+    double skillSkew = 1.0;         // Zipf exponent over the skill list, 0 = uniform
+
+    double gpaOutOfTen = 0.25;      // "CGPA: 9.0/10" instead of "GPA: 3.7"
+    double gpaMissing = 0.10;
+    int maxExperienceLines = 3;     // 1..N "Experience:" clauses
+    double certProbability = 0.5;   // chance of each of up to two certifications
+
+    double noSkillsLine = 0.10;     // skills only in free text (parser fallback path)
+    double noNameLine = 0.15;       // name on the first line without "Name:"
+    int fillerLines = 4;            // free-text lines of a "Summary" section
+};
+
+// Writes resume_000000.txt ... into resumeFolder and job_00.txt ... into jobFolder
+// (both created if needed). Returns the number of bytes written, 0 on error.
+uint64_t writeCorpus(const string& resumeFolder, const string& jobFolder, const CorpusOptions& options);
+
+#endif // CORPUS_H
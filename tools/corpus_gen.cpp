@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "corpus.h"
+
+using namespace std;
+
+// corpus_gen: writes a synthetic resume corpus plus matching job descriptions for
+// benchmarking (see README, "Benchmarks")
+
+static void printUsage()
+{
+    cout << "Usage: corpus_gen OUT_DIR [options]\n";
+    cout << "Writes OUT_DIR/resumes/resume_NNNNNN.txt and OUT_DIR/jobs/job_NN.txt\n";
+    cout << "  --resumes N          number of resumes (default 1000)\n";
+    cout << "  --jobs N             number of job descriptions (default 4)\n";
+    cout << "  --seed S             random seed (default 1)\n";
+    cout << "  --skills MIN MAX     skills per resume (default 3 10)\n";
+    cout << "  --skew X             Zipf exponent of skill popularity, 0 = uniform (default 1.0)\n";
+    cout << "  --gpa-out-of-ten F   fraction of GPAs written as 9.0/10 (default 0.25)\n";
+    cout << "  --gpa-missing F      fraction of resumes without a GPA (default 0.10)\n";
+    cout << "  --experience N       up to N experience clauses per resume (default 3)\n";
+    cout << "  --certs P            chance of each of up to two certifications (default 0.5)\n";
+    cout << "  --no-skills-line F   fraction of resumes with skills only in free text (default 0.10)\n";
+    cout << "  --no-name-line F     fraction of resumes without a \"Name:\" line (default 0.15)\n";
+    cout << "  --filler N           free-text lines per resume (default 4)\n";
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argv[1][0] == '-') {
+        printUsage();
+        return 1;
+    }
+    string outDir = argv[1];
+    CorpusOptions o;
+    for (int i = 2; i < argc; ++i) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--resumes" && hasValue) o.resumes = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--jobs" && hasValue) o.jobs = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed" && hasValue) o.seed = strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--skills" && i + 2 < argc) {
+            o.minSkills = atoi(argv[++i]);
+            o.maxSkills = atoi(argv[++i]);
+        }
+        else if (arg == "--skew" && hasValue) o.skillSkew = atof(argv[++i]);
+        else if (arg == "--gpa-out-of-ten" && hasValue) o.gpaOutOfTen = atof(argv[++i]);
+        else if (arg == "--gpa-missing" && hasValue) o.gpaMissing = atof(argv[++i]);
+        else if (arg == "--experience" && hasValue) o.maxExperienceLines = atoi(argv[++i]);
+        else if (arg == "--certs" && hasValue) o.certProbability = atof(argv[++i]);
+        else if (arg == "--no-skills-line" && hasValue) o.noSkillsLine = atof(argv[++i]);
+        else if (arg == "--no-name-line" && hasValue) o.noNameLine = atof(argv[++i]);
+        else if (arg == "--filler" && hasValue) o.fillerLines = atoi(argv[++i]);
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    uint64_t bytes = writeCorpus(outDir + "/resumes", outDir + "/jobs", o);
+    if (bytes == 0) return 1;
+    cout << "Wrote " << o.resumes << " resumes and " << o.jobs << " jobs (" << bytes << " bytes) to " << outDir << "\n";
+    return 0;
+}
@@ -1,61 +1,252 @@
-#include "utils.h"
-#include <algorithm>
-#include <cctype>
-#include <sstream>
-
-using namespace std;
-
-string toLower(string s)
-{
-    transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return tolower(c); });
-    return s;
-}
-
-string trim(const string& s)
-{
-    size_t start = 0;
-    while (start < s.size() && isspace((unsigned char)s[start])) start++;
-    if (start == s.size()) return "";
-    size_t end = s.size() - 1;
-    while (end > start && isspace((unsigned char)s[end])) end--;
-    return s.substr(start, end - start + 1);
-}
-
-vector<string> splitByMultiple(const string& s, const string& delims)
-{
-    vector<string> res;
-    string token;
-    for (char c : s) {
-        if (delims.find(c) != string::npos) {
-            if (!token.empty()) {
-                res.push_back(trim(token));
-                token.clear();
-            }
-        }
-        else {
-            token.push_back(c);
-        }
-    }
-    if (!token.empty()) res.push_back(trim(token));
-    return res;
-}
-
-// simple token-contained checker (word boundary not enforced, simple use)
-bool containsToken(const string& text, const string& token)
-{
-    if (token.empty()) return false;
-    string lt = toLower(text);
-    string lk = toLower(token);
-    return lt.find(lk) != string::npos;
-}
-
-// normalize skill text: lowercase, trim, replace common synonyms if needed
-string normalizeSkill(const string& s)
-{
-    string t = toLower(s);
-    t = trim(t);
-    // basic synonyms
-    if (t == "cpp") return "c++";
-    if (t == "js") return "javascript";
-    return t;
-}
\ No newline at end of file
+#include "utils.h"
+#include "skillalias.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define UTILS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTILS_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+static inline unsigned char foldByte(unsigned char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? (unsigned char)(ch | 0x20) : ch;
+}
+
+#ifdef UTILS_SSE2
+// 'A'..'Z' -> 'a'..'z'; bytes >= 0x80 are negative as signed chars and stay as they are
+static inline __m128i foldBlock16(__m128i x)
+{
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(x, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+#endif
+
+#ifdef UTILS_AVX2
+static inline __m256i foldBlock32(__m256i x)
+{
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), x));
+    return _mm256_or_si256(x, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+#endif
+
+static inline unsigned trailingZeros(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+string toLower(string s)
+{
+    lowerAscii(&s[0], s.data(), s.size());
+    return s;
+}
+
+string trim(const string& s)
+{
+    return string(trimView(s));
+}
+
+vector<string> splitByMultiple(const string& s, const string& delims)
+{
+    vector<string> res;
+    string token;
+    for (char c : s) {
+        if (delims.find(c) != string::npos) {
+            if (!token.empty()) {
+                res.push_back(trim(token));
+                token.clear();
+            }
+        }
+        else {
+            token.push_back(c);
+        }
+    }
+    if (!token.empty()) res.push_back(trim(token));
+    return res;
+}
+
+// simple token-contained checker (word boundary not enforced, simple use)
+bool containsToken(string_view text, string_view token)
+{
+    if (token.empty()) return false;
+    return findNoCase(text, token) != string_view::npos;
+}
+
+// normalize skill text: lowercase, trim, replace common synonyms if needed
+string normalizeSkill(const string& s)
+{
+    string t;
+    appendNormalizedSkill(t, s);
+    return t;
+}
+
+string_view trimView(string_view s)
+{
+    size_t start = 0;
+    while (start < s.size() && isspace((unsigned char)s[start])) start++;
+    size_t end = s.size();
+    while (end > start && isspace((unsigned char)s[end - 1])) end--;
+    return s.substr(start, end - start);
+}
+
+void appendNormalizedSkill(string& out, string_view s)
+{
+    size_t start = out.size();
+    appendLower(out, trimView(s));
+    string_view added(out.data() + start, out.size() - start);
+    // synonyms ("cpp" -> "c++", plus any [aliases] from the dictionary file)
+    string_view canonical;
+    if (findAlias(skillAliases(), added, canonical)) {
+        out.resize(start);
+        out += canonical;
+    }
+}
+
+void appendJsonString(string& out, string_view s)
+{
+    out += '"';
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') { out += '\\'; out += ch; }
+        else if ((unsigned char)ch < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", ch);
+            out += buf;
+        }
+        else out += ch;
+    }
+    out += '"';
+}
+
+uint64_t hashBytes(string_view s)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char ch : s) {
+        h ^= ch;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool parseUnsigned(const char* s, uint64_t maxValue, uint64_t& out)
+{
+    // strtoull alone would skip spaces, accept "-1" (wrapped) and stop quietly at "12abc"
+    if (!isdigit((unsigned char)s[0])) return false;
+    errno = 0;
+    char* end = nullptr;
+    const unsigned long long v = strtoull(s, &end, 10);
+    if (*end != '\0' || errno == ERANGE || v > maxValue) return false;
+    out = v;
+    return true;
+}
+
+void lowerAscii(char* dst, const char* src, size_t n)
+{
+    size_t i = 0;
+#ifdef UTILS_AVX2
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), foldBlock32(x));
+    }
+#endif
+#ifdef UTILS_SSE2
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), foldBlock16(x));
+    }
+#endif
+    for (; i < n; ++i) dst[i] = (char)foldByte((unsigned char)src[i]);
+}
+
+void appendLower(string& out, string_view s)
+{
+    size_t start = out.size();
+    out.resize(start + s.size());
+    lowerAscii(&out[start], s.data(), s.size());
+}
+
+bool equalsNoCase(string_view s, string_view word)
+{
+    if (s.size() != word.size()) return false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (foldByte((unsigned char)s[i]) != foldByte((unsigned char)word[i])) return false;
+    }
+    return true;
+}
+
+// Candidate positions come from comparing a whole block of text against the needle's
+// first and last byte at once (both folded); only positions where both match are
+// checked byte by byte. The scalar loop finishes whatever the blocks cannot reach.
+size_t findNoCase(string_view text, string_view needle)
+{
+    const size_t n = text.size();
+    const size_t m = needle.size();
+    if (m == 0) return 0;
+    if (m > n) return string_view::npos;
+    const unsigned char first = foldByte((unsigned char)needle[0]);
+    const unsigned char last = foldByte((unsigned char)needle[m - 1]);
+    const char* t = text.data();
+    size_t i = 0;
+
+    auto matchesAt = [&](size_t pos) {
+        for (size_t k = 1; k + 1 < m; ++k) {
+            if (foldByte((unsigned char)t[pos + k]) != foldByte((unsigned char)needle[k])) return false;
+        }
+        return true;
+    };
+
+#ifdef UTILS_AVX2
+    {
+        const __m256i vf = _mm256_set1_epi8((char)first);
+        const __m256i vl = _mm256_set1_epi8((char)last);
+        for (; i + m - 1 + 32 <= n; i += 32) {
+            __m256i bf = foldBlock32(_mm256_loadu_si256((const __m256i*)(t + i)));
+            __m256i bl = foldBlock32(_mm256_loadu_si256((const __m256i*)(t + i + m - 1)));
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, vf), _mm256_cmpeq_epi8(bl, vl)));
+            while (mask) {
+                unsigned bit = trailingZeros(mask);
+                if (matchesAt(i + bit)) return i + bit;
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+#ifdef UTILS_SSE2
+    {
+        const __m128i vf = _mm_set1_epi8((char)first);
+        const __m128i vl = _mm_set1_epi8((char)last);
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            __m128i bf = foldBlock16(_mm_loadu_si128((const __m128i*)(t + i)));
+            __m128i bl = foldBlock16(_mm_loadu_si128((const __m128i*)(t + i + m - 1)));
+            unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, vf), _mm_cmpeq_epi8(bl, vl)));
+            while (mask) {
+                unsigned bit = trailingZeros(mask);
+                if (matchesAt(i + bit)) return i + bit;
+                mask &= mask - 1;
+            }
+        }
+    }
+#endif
+    for (; i + m <= n; ++i) {
+        if (foldByte((unsigned char)t[i]) == first && foldByte((unsigned char)t[i + m - 1]) == last && matchesAt(i)) return i;
+    }
+    return string_view::npos;
+}
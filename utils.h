@@ -1,15 +1,91 @@
-#ifndef UTILS_H
-#define UTILS_H
-
-#include <string>
-#include <vector>
-
-using namespace std;
-
-string toLower(string s);
-string trim(const string& s);
-vector<string> splitByMultiple(const string& s, const string& delims);
-bool containsToken(const string& text, const string& token);
-string normalizeSkill(const string& s);
-
-#endif // UTILS_H#pragma once
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+string toLower(string s);
+string trim(const string& s);
+vector<string> splitByMultiple(const string& s, const string& delims);
+bool containsToken(string_view text, string_view token);
+string normalizeSkill(const string& s);
+
+// appends s as a quoted JSON string (quotes, backslashes and control bytes escaped)
+void appendJsonString(string& out, string_view s);
+
+// 64-bit FNV-1a hash of a byte string
+uint64_t hashBytes(string_view s);
+
+// Command-line numbers: the whole of s must be decimal digits (no sign, no trailing
+// text) and the value at most maxValue, else false and out is left alone.
+bool parseUnsigned(const char* s, uint64_t maxValue, uint64_t& out);
+
+// allocation-free helpers for the resume hot path
+string_view trimView(string_view s);
+// appends the normalized form of s (trimmed, lowercased, aliases resolved through
+// skillAliases()) to out
+void appendNormalizedSkill(string& out, string_view s);
+
+// ASCII case folding, 16 or 32 bytes at a time with SSE2 / AVX2 where available.
+// Only 'A'..'Z' change, which is what tolower() does in the default "C" locale.
+void lowerAscii(char* dst, const char* src, size_t n);
+// appends the lowercase form of s to out (no allocation once out has grown)
+void appendLower(string& out, string_view s);
+// case-insensitive s == word
+bool equalsNoCase(string_view s, string_view word);
+// position of the first case-insensitive occurrence of needle in text, or npos
+size_t findNoCase(string_view text, string_view needle);
+
+// Cursor over the items of a list separated by any of `delims`; every nextListItem
+// call yields the next trimmed, non-empty item as a view into the original text.
+struct ListCursor {
+    string_view rest;
+    string_view delims;
+    bool done = false;
+};
+
+inline bool nextListItem(ListCursor& cur, string_view& item)
+{
+    while (!cur.done) {
+        size_t end = cur.rest.find_first_of(cur.delims);
+        string_view raw = cur.rest.substr(0, end);
+        if (end == string_view::npos) cur.done = true;
+        else cur.rest.remove_prefix(end + 1);
+        item = trimView(raw);
+        if (!item.empty()) return true;
+    }
+    return false;
+}
+
+// Takes the next '\n'-terminated line off the front of rest (without the '\n');
+// false once rest is empty. A final line without '\n' is still returned.
+inline bool nextLine(string_view& rest, string_view& line)
+{
+    if (rest.empty()) return false;
+    size_t nl = rest.find('\n');
+    if (nl == string_view::npos) {
+        line = rest;
+        rest = string_view();
+    }
+    else {
+        line = rest.substr(0, nl);
+        rest.remove_prefix(nl + 1);
+    }
+    return true;
+}
+
+// Calls fn(item) for every trimmed, non-empty item of a list separated by any of
+// `delims`. Yields the same items as splitByMultiple (minus empty ones) without copies.
+template <class Fn>
+void forEachListItem(string_view s, string_view delims, Fn fn)
+{
+    ListCursor cur{ s, delims };
+    string_view item;
+    while (nextListItem(cur, item)) fn(item);
+}
+
+#endif // UTILS_H
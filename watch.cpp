@@ -0,0 +1,319 @@
+#include "watch.h"
+#include "ranking.h"
+#include "report.h"
+#include "scorer.h"
+#include "stats.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <csignal>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const int QUIET_MS = 40;         // no new event for this long: the burst is over
+static const int MAX_DELAY_MS = 250;    // but never hold a change back longer than this
+static const int POLL_INTERVAL_MS = 1000;   // folder listing without inotify
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onStopSignal(int)
+{
+    stopRequested = 1;
+}
+
+struct RankLess {
+    bool operator()(const Candidate* a, const Candidate* b) const { return rankBefore(*a, *b); }
+};
+
+// what a file looked like when it was last parsed
+struct SeenFile {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+// a scored resume and what it added to the sketch, to be taken back out when the
+// file changes or goes away
+struct WatchEntry {
+    Candidate candidate;
+    ScoreParts parts;
+    vector<uint8_t> hasRequired;
+};
+
+struct WatchState {
+    const WatchOptions* options = nullptr;
+    Job job;
+    JobScorer scorer;
+    ScoreSketch sketch;                         // over every resume in byName
+    unordered_map<string, WatchEntry> byName;   // by file name within the folder
+    unordered_map<string, SeenFile> seen;
+    set<const Candidate*, RankLess> ranked;     // every candidate, best first
+    vector<const Candidate*> reportOrder;        // ranked as a list, reused by every report
+    unordered_set<string> pending;              // names changed since the last report
+};
+
+static bool isResumeName(const string& name)
+{
+    return fs::path(name).extension() == ".txt";
+}
+
+static bool stampFile(const fs::path& path, SeenFile& s)
+{
+    error_code ec;
+    if (!fs::is_regular_file(path, ec)) return false;
+    s.size = (uint64_t)fs::file_size(path, ec);
+    s.mtime = (int64_t)fs::last_write_time(path, ec).time_since_epoch().count();
+    return true;
+}
+
+static void removeCandidate(WatchState& st, const string& name)
+{
+    auto it = st.byName.find(name);
+    if (it == st.byName.end()) return;
+    st.ranked.erase(&it->second.candidate);
+    updateSketch(st.sketch, it->second.parts, it->second.hasRequired.data(), -1);
+    st.byName.erase(it);
+    st.seen.erase(name);
+}
+
+// scores c and puts it in the ranking under name, replacing an older version
+static void placeCandidate(WatchState& st, const string& name, Candidate&& c)
+{
+    scoreCandidate(st.scorer, c);
+    removeCandidate(st, name);
+    WatchEntry& e = st.byName[name];
+    e.candidate = move(c);
+    e.parts = st.scorer.parts;
+    e.hasRequired = st.scorer.hasRequired;
+    st.ranked.insert(&e.candidate);
+}
+
+// Parses the pending files that still exist (on the ingest threads) and drops the
+// ones that are gone, adding to the parsed / removed counts.
+static void applyPending(WatchState& st, size_t& parsed, size_t& removed)
+{
+    RF_TIMED_SCOPE("apply changes");
+    const fs::path folder(st.options->resumesFolder);
+    vector<string> names, paths;
+    vector<SeenFile> stamps;
+    for (auto& name : st.pending) {
+        SeenFile s;
+        if (!stampFile(folder / name, s)) {
+            if (st.byName.count(name)) removed++;
+            removeCandidate(st, name);
+            continue;
+        }
+        names.push_back(name);
+        paths.push_back((folder / name).string());
+        stamps.push_back(s);
+    }
+    st.pending.clear();
+
+    vector<Candidate> fresh(names.size());
+    parallelFor(names.size(), st.options->ingest.threads, [&](size_t i, int) {
+        fresh[i] = parseResumeFile(paths[i]);
+    });
+    for (size_t i = 0; i < names.size(); ++i) {
+        placeCandidate(st, names[i], move(fresh[i]));
+        st.seen[names[i]] = stamps[i];
+    }
+    parsed += names.size();
+}
+
+// Lists the folder and marks every file that is new, changed or gone since it was
+// last parsed. The fallback when there is no inotify, and the way back after the
+// kernel dropped events.
+static void rescanFolder(WatchState& st)
+{
+    RF_TIMED_SCOPE("rescan folder");
+    unordered_set<string> present;
+    try {
+        for (auto& ent : fs::directory_iterator(st.options->resumesFolder)) {
+            const string name = ent.path().filename().string();
+            if (!isResumeName(name)) continue;
+            SeenFile s;
+            if (!stampFile(ent.path(), s)) continue;
+            present.insert(name);
+            auto it = st.seen.find(name);
+            if (it == st.seen.end() || it->second.size != s.size || it->second.mtime != s.mtime) st.pending.insert(name);
+        }
+    }
+    catch (const std::exception& e) {
+        cout << "Error reading folder: " << e.what() << endl;
+        return;
+    }
+    for (auto& kv : st.byName) {
+        if (!present.count(kv.first)) st.pending.insert(kv.first);
+    }
+}
+
+// the whole ranking to a temporary file, renamed over the report so a reader never
+// sees a half-written one
+static bool writeWatchReport(WatchState& st)
+{
+    RF_TIMED_SCOPE("write watch report");
+    st.reportOrder.assign(st.ranked.begin(), st.ranked.end());
+    const string& path = st.options->reportPath;
+    const string temp = path + ".tmp";
+    if (!writeReport(temp, st.reportOrder, st.job, st.sketch)) return false;
+    error_code ec;
+    fs::rename(temp, path, ec);
+    return !ec;
+}
+
+static void publish(WatchState& st, chrono::steady_clock::time_point firstChange)
+{
+    size_t parsed = 0, removed = 0;
+    applyPending(st, parsed, removed);
+    const bool ok = writeWatchReport(st);
+    const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - firstChange).count();
+    cout << (ok ? "Report updated: " : "Failed to write report: ") << st.byName.size() << " resumes, "
+        << parsed << " parsed, " << removed << " removed, " << (long long)(ms + 0.5) << " ms after the first change" << endl;
+}
+
+#ifdef __linux__
+
+// Waits for inotify events and publishes each burst of changes. False if inotify is
+// not available, so the caller can fall back to polling.
+static bool watchWithInotify(WatchState& st)
+{
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) return false;
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF;
+    if (inotify_add_watch(fd, st.options->resumesFolder.c_str(), mask) < 0) {
+        close(fd);
+        return false;
+    }
+    // anything that changed between the first parse and the watch starting
+    rescanFolder(st);
+
+    using clock = chrono::steady_clock;
+    clock::time_point firstChange = clock::now(), lastChange = firstChange;
+    alignas(inotify_event) char buf[16384];
+    bool gone = false;
+    while (!stopRequested && !gone) {
+        int timeout = 200;
+        if (!st.pending.empty()) {
+            const auto now = clock::now();
+            const auto quietLeft = chrono::milliseconds(QUIET_MS) - (now - lastChange);
+            const auto delayLeft = chrono::milliseconds(MAX_DELAY_MS) - (now - firstChange);
+            timeout = (int)max<long long>(0, chrono::ceil<chrono::milliseconds>(min(quietLeft, delayLeft)).count());
+        }
+        pollfd p = { fd, POLLIN, 0 };
+        const int ready = poll(&p, 1, timeout);
+        if (ready < 0 && errno != EINTR) break;
+
+        if (ready > 0) {
+            const bool wasIdle = st.pending.empty();
+            bool overflow = false;
+            for (;;) {
+                const ssize_t n = read(fd, buf, sizeof(buf));
+                if (n <= 0) break;
+                for (ssize_t off = 0; off < n;) {
+                    const inotify_event* ev = (const inotify_event*)(buf + off);
+                    off += (ssize_t)sizeof(inotify_event) + ev->len;
+                    if (ev->mask & IN_Q_OVERFLOW) overflow = true;
+                    if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) gone = true;
+                    if (ev->len > 0 && isResumeName(ev->name)) st.pending.insert(ev->name);
+                }
+            }
+            // the kernel queue filled up and events were lost: compare with a listing
+            if (overflow) rescanFolder(st);
+            if (!st.pending.empty()) {
+                lastChange = clock::now();
+                if (wasIdle) firstChange = lastChange;
+            }
+        }
+
+        if (st.pending.empty()) continue;
+        const auto now = clock::now();
+        if (now - lastChange >= chrono::milliseconds(QUIET_MS) || now - firstChange >= chrono::milliseconds(MAX_DELAY_MS)) publish(st, firstChange);
+    }
+    close(fd);
+    if (gone) cout << "The resume folder was removed or moved away; stopping." << endl;
+    return true;
+}
+
+#else
+
+static bool watchWithInotify(WatchState&)
+{
+    return false;
+}
+
+#endif
+
+static void watchByPolling(WatchState& st)
+{
+    while (!stopRequested) {
+        for (int waited = 0; waited < POLL_INTERVAL_MS && !stopRequested; waited += 100) {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+        if (stopRequested) break;
+        const auto started = chrono::steady_clock::now();
+        rescanFolder(st);
+        if (!st.pending.empty()) publish(st, started);
+    }
+}
+
+int runWatch(const WatchOptions& o)
+{
+    error_code ec;
+    if (!fs::is_directory(o.resumesFolder, ec)) {
+        cout << "--watch needs a resume folder: " << o.resumesFolder << "\n";
+        return 1;
+    }
+    WatchState st;
+    st.options = &o;
+    st.job = parseJobDescription(o.jobFile);
+    if (o.profileSet) st.job.profile = o.profile;
+    prepareScorer(st.scorer, st.job);
+    startSketch(st.sketch, st.job);
+    st.scorer.sketch = &st.sketch;
+
+    // the first version of every file, scored and ranked as if it had just arrived
+    {
+        RF_TIMED_SCOPE("read resumes");
+        // stamped when the folder was listed, before reading: a file rewritten in
+        // between keeps its old mtime here and is parsed again by the first rescan
+        vector<FileStamp> stamps;
+        vector<Candidate> candidates = parseResumesFromFolder(o.resumesFolder, o.ingest, nullptr, &stamps);
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            Candidate& c = candidates[i];
+            const string name = fs::path(string(spanText(c, c.filepath))).filename().string();
+            placeCandidate(st, name, move(c));
+            st.seen[name] = SeenFile{ stamps[i].size, stamps[i].mtime };
+        }
+    }
+    if (!writeWatchReport(st)) {
+        cout << "Failed to write report: " << o.reportPath << "\n";
+        return 1;
+    }
+    cout << "Report written to: " << o.reportPath << " (" << st.byName.size() << " resumes)\n";
+
+    signal(SIGINT, onStopSignal);
+    signal(SIGTERM, onStopSignal);
+    cout << "Watching " << o.resumesFolder << " for changes (Ctrl+C to stop)" << endl;
+    if (!watchWithInotify(st)) {
+        cout << "inotify is not available; checking the folder every " << POLL_INTERVAL_MS / 1000 << " s" << endl;
+        watchByPolling(st);
+    }
+    // changes that arrived just before the stop still make it into the report
+    if (!st.pending.empty()) publish(st, chrono::steady_clock::now());
+    cout << "Stopped watching" << endl;
+    return 0;
+}
@@ -0,0 +1,29 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include "parser.h"
+#include <string>
+
+using namespace std;
+
+struct WatchOptions {
+    string resumesFolder;
+    string jobFile;
+    string reportPath = "selected_candidates_report.txt";
+    IngestOptions ingest;       // the first parse, and the threads re-parsing a burst of files
+    bool profileSet = false;    // score with `profile`, whatever the job file says
+    ScoringProfile profile = PROFILE_ENGINEERING;
+};
+
+// Keeps the report up to date while resumes come and go. The folder is parsed and
+// scored once; after that the folder is watched (inotify on Linux, a listing every
+// second elsewhere) and only the files that were written, moved in, moved out or
+// deleted are parsed again, rescored against the job and moved within the ranking.
+// Changes arriving in a burst are gathered until the folder is quiet for a moment (at
+// most a quarter of a second), then the report is rewritten once, replacing the old
+// one in a single rename. Keyword relevance is scored per resume, as with --top, so
+// a change never moves the other resumes. Runs until SIGINT / SIGTERM; returns the
+// process exit code.
+int runWatch(const WatchOptions& options);
+
+#endif // WATCH_H